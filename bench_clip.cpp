@@ -0,0 +1,112 @@
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geo2_util.h"
+#include "geo2_clip.h"
+
+using namespace std;
+using namespace Geo2Util;
+
+// Throughput of the batched viewport clipping, single thread (shapes per second per core),
+// and agreement of the clipped geometry with CGAL, on random shapes and on hand-picked boundary cases
+// (shapes along an edge, through or touching a corner, with a vertex on the boundary).
+// usage: geo2d_clip_bench [shapes per type]
+
+template <typename ShapeVisual>
+static void run(const string& name, const vector<ShapeVisual>& shapes, const Iso_rectangle_2& viewport)
+{
+    Viewport vp = toViewport(viewport);
+
+    auto start = chrono::steady_clock::now();
+    auto batch = toBatch(shapes);
+    auto clipped = clip(batch, vp);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t mismatches = countClipMismatches(shapes, viewport);
+
+    cout << name << ": " << shapes.size() << " in, " << clipped.size() << " out, "
+            << static_cast<long long>(shapes.size() / seconds) << " shapes/s/core, "
+            << mismatches << " mismatches vs CGAL\n";
+}
+
+static Point_2_Visual P(double x, double y)
+{
+    return Point_2_Visual(Point_2(x, y));
+}
+
+// Boundary cases against the viewport [-2, 2]^2; returns the number of mismatches
+static size_t checkBoundaryCases()
+{
+    Iso_rectangle_2 viewport(Point_2(-2, -2), Point_2(2, 2));
+
+    vector<Segment_2_Visual> segments = {
+        Segment_2_Visual(P(2, -1), P(2, 1)),    // on an edge
+        Segment_2_Visual(P(2, -3), P(2, 3)),    // along an edge, beyond both corners
+        Segment_2_Visual(P(1, 3), P(3, 1)),     // touching a corner
+        Segment_2_Visual(P(2, 0), P(5, 0)),     // endpoint on the boundary, pointing out
+        Segment_2_Visual(P(2, 2), P(3, 3)),     // endpoint on a corner, pointing out
+        Segment_2_Visual(P(-3, -3), P(3, 3)),   // through two corners
+        Segment_2_Visual(P(2, 3), P(2, 5)),     // on the line of an edge, outside
+        Segment_2_Visual(P(0, 0), P(1, 1))      // inside
+    };
+    vector<Triangle_2_Visual> triangles = {
+        Triangle_2_Visual(P(2, -1), P(2, 1), P(4, 0)),        // sharing part of an edge, outside
+        Triangle_2_Visual(P(2, 2), P(3, 2), P(2, 3)),         // touching a corner
+        Triangle_2_Visual(P(2, 0), P(5, 1), P(5, -1)),        // vertex on the boundary, outside
+        Triangle_2_Visual(P(2, -1), P(2, 1), P(0, 0)),        // sharing part of an edge, inside
+        Triangle_2_Visual(P(0, 0), P(4, 1), P(4, -1)),        // crossing an edge
+        Triangle_2_Visual(P(1, 1), P(3, 1), P(1, 3)),         // cutting a corner
+        Triangle_2_Visual(P(-10, -10), P(10, -10), P(0, 10)), // containing the viewport
+        Triangle_2_Visual(P(-1, -1), P(1, -1), P(0, 1)),      // inside
+        Triangle_2_Visual(P(-1, -1), P(0, 0), P(1, 1)),       // inside, collinear vertices
+        Triangle_2_Visual(P(-2, 0), P(2, 0), P(0, 0))         // inside, collinear along a line touching two edges
+    };
+    vector<Iso_rectangle_2_Visual> rectangles = {
+        Iso_rectangle_2_Visual(P(2, -1), P(3, 1)),  // sharing part of an edge
+        Iso_rectangle_2_Visual(P(2, 2), P(3, 3)),   // touching a corner
+        Iso_rectangle_2_Visual(P(-3, -3), P(3, 3)), // containing the viewport
+        Iso_rectangle_2_Visual(P(3, 3), P(4, 4))    // outside
+    };
+
+    size_t segmentMismatches = countClipMismatches(segments, viewport);
+    size_t triangleMismatches = countClipMismatches(triangles, viewport);
+    size_t rectangleMismatches = countClipMismatches(rectangles, viewport);
+    cout << "boundary cases: " << segmentMismatches << " segment, " << triangleMismatches << " triangle, "
+            << rectangleMismatches << " rectangle mismatches vs CGAL\n";
+    return segmentMismatches + triangleMismatches + rectangleMismatches;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> coord(-100.0, 100.0);
+    auto randomPoint = [&]() { return Point_2_Visual(Point_2(coord(rng), coord(rng))); };
+
+    Iso_rectangle_2 viewport(Point_2(-50, -50), Point_2(50, 50));
+
+    vector<Segment_2_Visual> segments;
+    vector<Triangle_2_Visual> triangles;
+    vector<Iso_rectangle_2_Visual> rectangles;
+    segments.reserve(n);
+    triangles.reserve(n);
+    rectangles.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        segments.push_back(Segment_2_Visual(randomPoint(), randomPoint()));
+        triangles.push_back(Triangle_2_Visual(randomPoint(), randomPoint(), randomPoint()));
+        rectangles.push_back(Iso_rectangle_2_Visual(randomPoint(), randomPoint()));
+    }
+
+    cout << "outcodes: " << outcodePath() << "\n";
+    size_t boundaryMismatches = checkBoundaryCases();
+    run("segments", segments, viewport);
+    run("triangles", triangles, viewport);
+    run("rectangles", rectangles, viewport);
+    return boundaryMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geo2_util.h"
+#include "geo2_scene.h"
+#include "geo2_shard.h"
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Geo2Util;
+namespace fs = std::filesystem;
+
+// Throughput of the streaming shard merge.
+// Generates `shards` binary shards of random geometry totalling about `total GB` in `dir`,
+// merges them with mergeShards, checks the global index and removes the files.
+// The merge is timed twice: cold, with the shards synced and evicted from the page cache first,
+// and warm, with the shards left in the cache by the cold run. Both timings include syncing the output.
+// usage: geo2d_merge_bench [shards] [total GB] [dir]
+
+// Write a file back to disk and drop it from the page cache; returns false where this is not supported
+static bool evictFromCache(const string& filename)
+{
+#if defined(__unix__) && defined(POSIX_FADV_DONTNEED)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    // Only clean pages are dropped, so the file is synced first
+    bool ok = fsync(fd) == 0 && posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    close(fd);
+    return ok;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+// Merge the shards and sync the output; returns the elapsed seconds
+static double timedMerge(const vector<string>& files, const string& output, uint64_t& bytes)
+{
+    auto start = chrono::steady_clock::now();
+    bytes = mergeShards(files, output);
+    evictFromCache(output);
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    size_t shardCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 64;
+    double totalGB = argc > 2 ? strtod(argv[2], nullptr) : 50.0;
+    fs::path dir = argc > 3 ? argv[3] : "merge_bench";
+    if (shardCount == 0 || totalGB <= 0) {
+        cerr << "usage: geo2d_merge_bench [shards] [total GB] [dir]\n";
+        return 2;
+    }
+    fs::create_directories(dir);
+
+    // One shape of every type per group
+    uint64_t groupSize = 0;
+    for (int t = 0; t < ShapeTypeCount; t++) {
+        groupSize += binaryRecordSize(t);
+    }
+    uint64_t groupsPerShard = static_cast<uint64_t>(totalGB * 1e9 / shardCount / groupSize);
+
+    mt19937_64 rng(42);
+    uniform_real_distribution<double> coord(-1000.0, 1000.0);
+    uniform_int_distribution<int> channel(0, 255);
+    auto randomColor = [&]() { return Color{static_cast<short>(channel(rng)), static_cast<short>(channel(rng)), static_cast<short>(channel(rng)), 255}; };
+    auto randomPoint = [&]() { return Point_2_Visual(Point_2(coord(rng), coord(rng))); };
+
+    vector<string> files;
+    auto start = chrono::steady_clock::now();
+    for (size_t s = 0; s < shardCount; s++) {
+        Scene scene;
+        for (uint64_t i = 0; i < groupsPerShard; i++) {
+            scene.points.push_back(randomPoint());
+            scene.segments.push_back(Segment_2_Visual(randomPoint(), randomPoint(), randomColor(), BoundaryType::Solid));
+            scene.circles.push_back(Circle_2_Visual(randomPoint(), 25.0, randomColor(), randomColor(), BoundaryType::Dashed));
+            scene.triangles.push_back(Triangle_2_Visual(randomPoint(), randomPoint(), randomPoint(), randomColor(), randomColor(), BoundaryType::Solid));
+            scene.rectangles.push_back(Iso_rectangle_2_Visual(randomPoint(), randomPoint(), randomColor(), randomColor(), BoundaryType::Dotted));
+        }
+        // Shards are written in reverse so the merge has to order them by id
+        size_t id = shardCount - 1 - s;
+        files.push_back((dir / ("shard." + to_string(id) + ".bin")).string());
+        writeBinary(files.back(), scene, static_cast<uint32_t>(id), static_cast<uint32_t>(shardCount));
+    }
+    double generateSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    uint64_t inputBytes = 0;
+    for (const string& file : files) {
+        inputBytes += fs::file_size(file);
+    }
+    cout << "generated " << shardCount << " shards, " << inputBytes / 1e9 << " GB in " << generateSeconds << " s\n";
+
+    bool evicted = true;
+    for (const string& file : files) {
+        evicted = evictFromCache(file) && evicted;
+    }
+
+    string output = (dir / "merged.bin").string();
+    uint64_t bytes = 0;
+    double coldSeconds = timedMerge(files, output, bytes);
+    cout << "cold merge: " << bytes / 1e9 << " GB in " << coldSeconds << " s, " << bytes / 1e9 / coldSeconds << " GB/s"
+            << (evicted ? "" : " (page cache eviction not supported, shards may be cached)") << "\n";
+
+    double warmSeconds = timedMerge(files, output, bytes);
+    cout << "warm merge: " << bytes / 1e9 << " GB in " << warmSeconds << " s, " << bytes / 1e9 / warmSeconds << " GB/s\n";
+
+    ifstream in(output, ios::binary);
+    BinaryHeader header = readBinaryHeader(in, output);
+    bool ok = header.index.size() == shardCount && fs::file_size(output) == bytes;
+    for (size_t i = 0; ok && i < header.index.size(); i++) {
+        ok = header.index[i].shardId == i && header.index[i].first[0] == i * groupsPerShard;
+    }
+    cout << "global index " << (ok ? "ok" : "MISMATCH") << "\n";
+
+    for (const string& file : files) {
+        fs::remove(file);
+    }
+    fs::remove(output);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,610 @@
+#include <CGAL/intersections.h>
+#include <CGAL/version.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#if CGAL_VERSION_NR >= 1060000000
+#include <variant>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GEO2_CLIP_SSE2 1
+#endif
+
+#include "geo2_clip.h"
+
+namespace Geo2Util {
+
+    // Cohen-Sutherland outcode bits
+    enum : unsigned char {
+        OutLeft = 1,
+        OutRight = 2,
+        OutBottom = 4,
+        OutTop = 8
+    };
+
+    // Polygon vertex used by Sutherland-Hodgman; origin is the triangle vertex (0..2) whose style it carries
+    struct ClipVertex {
+        double x;
+        double y;
+        int origin;
+    };
+
+    // A triangle clipped by four half-planes has at most 3 + 4 vertices
+    const int MaxClipVertices = 8;
+
+    static unsigned char outcode(double x, double y, const Viewport& vp) {
+        return static_cast<unsigned char>((x < vp.xmin)
+                | ((x > vp.xmax) << 1)
+                | ((y < vp.ymin) << 2)
+                | ((y > vp.ymax) << 3));
+    }
+
+    /**
+     * @brief Compute outcodes for n points stored as separate x and y arrays
+     * @details Two points per step with SSE2 packed compares (part of the x86-64 baseline); scalar loop elsewhere and for the tail
+     */
+    static void outcodes(const double* x, const double* y, std::size_t n, const Viewport& vp, unsigned char* codes) {
+        const double xmin = vp.xmin, ymin = vp.ymin, xmax = vp.xmax, ymax = vp.ymax;
+        std::size_t i = 0;
+#ifdef GEO2_CLIP_SSE2
+        const __m128d vxmin = _mm_set1_pd(xmin), vymin = _mm_set1_pd(ymin);
+        const __m128d vxmax = _mm_set1_pd(xmax), vymax = _mm_set1_pd(ymax);
+        for (; i + 2 <= n; i += 2) {
+            __m128d vx = _mm_loadu_pd(x + i);
+            __m128d vy = _mm_loadu_pd(y + i);
+            // Bit k of each mask is the compare result of lane k
+            int left = _mm_movemask_pd(_mm_cmplt_pd(vx, vxmin));
+            int right = _mm_movemask_pd(_mm_cmpgt_pd(vx, vxmax));
+            int bottom = _mm_movemask_pd(_mm_cmplt_pd(vy, vymin));
+            int top = _mm_movemask_pd(_mm_cmpgt_pd(vy, vymax));
+            codes[i] = static_cast<unsigned char>((left & 1)
+                    | ((right & 1) << 1)
+                    | ((bottom & 1) << 2)
+                    | ((top & 1) << 3));
+            codes[i + 1] = static_cast<unsigned char>((left >> 1)
+                    | ((right >> 1) << 1)
+                    | ((bottom >> 1) << 2)
+                    | ((top >> 1) << 3));
+        }
+#endif
+        for (; i < n; i++) {
+            codes[i] = static_cast<unsigned char>((x[i] < xmin)
+                    | ((x[i] > xmax) << 1)
+                    | ((y[i] < ymin) << 2)
+                    | ((y[i] > ymax) << 3));
+        }
+    }
+
+    const char* outcodePath() {
+#ifdef GEO2_CLIP_SSE2
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    static PointStyle styleOf(const Point_2_Visual& pv) {
+        return PointStyle{pv.getBondaryColor(), pv.getInteriorColor(), pv.getBoundaryType()};
+    }
+
+    static Point_2_Visual makePoint(double x, double y, const PointStyle& style) {
+        return Point_2_Visual(Point_2(x, y), style.boundaryColor, style.interiorColor, style.bType);
+    }
+
+    /**
+     * @brief Cohen-Sutherland clipping of one segment whose endpoint outcodes are already known
+     * @return false if the segment lies outside the viewport
+     */
+    static bool clipSegment(double& x0, double& y0, double& x1, double& y1, unsigned char c0, unsigned char c1, const Viewport& vp) {
+        while (true) {
+            if (!(c0 | c1)) {
+                return true;
+            }
+            if (c0 & c1) {
+                return false;
+            }
+
+            unsigned char c = c0 ? c0 : c1;
+            double x, y;
+            if (c & OutTop) {
+                x = x0 + (x1 - x0) * (vp.ymax - y0) / (y1 - y0);
+                y = vp.ymax;
+            } else if (c & OutBottom) {
+                x = x0 + (x1 - x0) * (vp.ymin - y0) / (y1 - y0);
+                y = vp.ymin;
+            } else if (c & OutRight) {
+                y = y0 + (y1 - y0) * (vp.xmax - x0) / (x1 - x0);
+                x = vp.xmax;
+            } else {
+                y = y0 + (y1 - y0) * (vp.xmin - x0) / (x1 - x0);
+                x = vp.xmin;
+            }
+
+            if (c == c0) {
+                x0 = x;
+                y0 = y;
+                c0 = outcode(x0, y0, vp);
+            } else {
+                x1 = x;
+                y1 = y;
+                c1 = outcode(x1, y1, vp);
+            }
+        }
+    }
+
+    /**
+     * @brief One Sutherland-Hodgman pass against an axis-aligned boundary
+     * @param axis 0 for a vertical boundary (x = bound), 1 for a horizontal one (y = bound)
+     * @param keepGreater true to keep the side with coordinates >= bound
+     * @return Number of vertices written to out
+     */
+    static int clipPolygonEdge(const ClipVertex* in, int n, ClipVertex* out, int axis, double bound, bool keepGreater) {
+        int m = 0;
+        for (int i = 0; i < n; i++) {
+            const ClipVertex& cur = in[i];
+            const ClipVertex& prev = in[(i + n - 1) % n];
+            double cc = axis == 0 ? cur.x : cur.y;
+            double pc = axis == 0 ? prev.x : prev.y;
+            bool curIn = keepGreater ? cc >= bound : cc <= bound;
+            bool prevIn = keepGreater ? pc >= bound : pc <= bound;
+
+            if (curIn != prevIn) {
+                double t = (bound - pc) / (cc - pc);
+                ClipVertex v;
+                if (axis == 0) {
+                    v.x = bound;
+                    v.y = prev.y + (cur.y - prev.y) * t;
+                } else {
+                    v.x = prev.x + (cur.x - prev.x) * t;
+                    v.y = bound;
+                }
+                v.origin = prev.origin;
+                out[m++] = v;
+            }
+            if (curIn) {
+                out[m++] = cur;
+            }
+        }
+        return m;
+    }
+
+    /**
+     * @brief Sutherland-Hodgman clipping of a polygon against the viewport
+     * @return Number of vertices left in poly
+     */
+    static int clipPolygon(ClipVertex* poly, int n, const Viewport& vp) {
+        ClipVertex tmp[MaxClipVertices];
+        n = clipPolygonEdge(poly, n, tmp, 0, vp.xmin, true);
+        n = clipPolygonEdge(tmp, n, poly, 0, vp.xmax, false);
+        n = clipPolygonEdge(poly, n, tmp, 1, vp.ymin, true);
+        n = clipPolygonEdge(tmp, n, poly, 1, vp.ymax, false);
+
+        // Interpolation may round a hair outside of the boundaries clipped earlier
+        for (int i = 0; i < n; i++) {
+            poly[i].x = std::min(std::max(poly[i].x, vp.xmin), vp.xmax);
+            poly[i].y = std::min(std::max(poly[i].y, vp.ymin), vp.ymax);
+        }
+        return n;
+    }
+
+    // Drop consecutive duplicates (including last == first) left by vertices lying on the viewport boundary
+    static int removeDuplicateVertices(ClipVertex* poly, int n) {
+        int m = 0;
+        for (int i = 0; i < n; i++) {
+            if (m == 0 || poly[i].x != poly[m - 1].x || poly[i].y != poly[m - 1].y) {
+                poly[m++] = poly[i];
+            }
+        }
+        while (m > 1 && poly[m - 1].x == poly[0].x && poly[m - 1].y == poly[0].y) {
+            m--;
+        }
+        return m;
+    }
+
+    // Twice the signed area of triangle (a, b, c)
+    static double cross(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c) {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+
+    /**
+     * @brief Convert Iso_rectangle_2 object to a viewport
+     * @param rect Iso_rectangle_2 object
+     * @return Viewport with the bounds of rect
+     */
+    Viewport toViewport(const Iso_rectangle_2& rect) {
+        return Viewport{CGAL::to_double(rect.xmin()), CGAL::to_double(rect.ymin()),
+                        CGAL::to_double(rect.xmax()), CGAL::to_double(rect.ymax())};
+    }
+
+// toBatch: extract coordinate arrays
+    SegmentBatch toBatch(const std::vector<Segment_2_Visual>& segments) {
+        SegmentBatch batch;
+        std::size_t n = segments.size();
+        batch.x0.reserve(n);
+        batch.y0.reserve(n);
+        batch.x1.reserve(n);
+        batch.y1.reserve(n);
+        batch.boundaryColor.reserve(n);
+        batch.bType.reserve(n);
+        batch.sourceStyle.reserve(n);
+        batch.targetStyle.reserve(n);
+
+        for (const Segment_2_Visual& segv : segments) {
+            Point_2_Visual s = segv.source();
+            Point_2_Visual t = segv.target();
+            batch.x0.push_back(CGAL::to_double(s.x()));
+            batch.y0.push_back(CGAL::to_double(s.y()));
+            batch.x1.push_back(CGAL::to_double(t.x()));
+            batch.y1.push_back(CGAL::to_double(t.y()));
+            batch.boundaryColor.push_back(segv.getBondaryColor());
+            batch.bType.push_back(segv.getBoundaryType());
+            batch.sourceStyle.push_back(styleOf(s));
+            batch.targetStyle.push_back(styleOf(t));
+        }
+        return batch;
+    }
+
+    TriangleBatch toBatch(const std::vector<Triangle_2_Visual>& triangles) {
+        TriangleBatch batch;
+        std::size_t n = triangles.size();
+        batch.x0.reserve(n);
+        batch.y0.reserve(n);
+        batch.x1.reserve(n);
+        batch.y1.reserve(n);
+        batch.x2.reserve(n);
+        batch.y2.reserve(n);
+        batch.boundaryColor.reserve(n);
+        batch.interiorColor.reserve(n);
+        batch.bType.reserve(n);
+        batch.vertexStyle.reserve(3 * n);
+
+        for (const Triangle_2_Visual& triv : triangles) {
+            Point_2_Visual p = triv.vertex(0);
+            Point_2_Visual q = triv.vertex(1);
+            Point_2_Visual r = triv.vertex(2);
+            batch.x0.push_back(CGAL::to_double(p.x()));
+            batch.y0.push_back(CGAL::to_double(p.y()));
+            batch.x1.push_back(CGAL::to_double(q.x()));
+            batch.y1.push_back(CGAL::to_double(q.y()));
+            batch.x2.push_back(CGAL::to_double(r.x()));
+            batch.y2.push_back(CGAL::to_double(r.y()));
+            batch.boundaryColor.push_back(triv.getBondaryColor());
+            batch.interiorColor.push_back(triv.getInteriorColor());
+            batch.bType.push_back(triv.getBoundaryType());
+            batch.vertexStyle.push_back(styleOf(p));
+            batch.vertexStyle.push_back(styleOf(q));
+            batch.vertexStyle.push_back(styleOf(r));
+        }
+        return batch;
+    }
+
+    RectangleBatch toBatch(const std::vector<Iso_rectangle_2_Visual>& rectangles) {
+        RectangleBatch batch;
+        std::size_t n = rectangles.size();
+        batch.xmin.reserve(n);
+        batch.ymin.reserve(n);
+        batch.xmax.reserve(n);
+        batch.ymax.reserve(n);
+        batch.boundaryColor.reserve(n);
+        batch.interiorColor.reserve(n);
+        batch.bType.reserve(n);
+        batch.minStyle.reserve(n);
+        batch.maxStyle.reserve(n);
+
+        for (const Iso_rectangle_2_Visual& rectv : rectangles) {
+            // The kernel object normalizes the corners
+            Iso_rectangle_2 rect = rectv.KernelObject();
+            batch.xmin.push_back(CGAL::to_double(rect.xmin()));
+            batch.ymin.push_back(CGAL::to_double(rect.ymin()));
+            batch.xmax.push_back(CGAL::to_double(rect.xmax()));
+            batch.ymax.push_back(CGAL::to_double(rect.ymax()));
+            batch.boundaryColor.push_back(rectv.getBondaryColor());
+            batch.interiorColor.push_back(rectv.getInteriorColor());
+            batch.bType.push_back(rectv.getBoundaryType());
+            batch.minStyle.push_back(styleOf(rectv.min()));
+            batch.maxStyle.push_back(styleOf(rectv.max()));
+        }
+        return batch;
+    }
+
+// clip: batched clipping
+    /**
+     * @brief Clip a batch of segments against the viewport (Cohen-Sutherland)
+     * @param batch Segment coordinate arrays
+     * @param vp Viewport
+     * @param sourceIndex Optional; receives the batch index of every returned segment
+     * @return Clipped segments with the style of their input segment
+     */
+    std::vector<Segment_2_Visual> clip(const SegmentBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex) {
+        std::size_t n = batch.size();
+        std::vector<unsigned char> c0(n), c1(n);
+        outcodes(batch.x0.data(), batch.y0.data(), n, vp, c0.data());
+        outcodes(batch.x1.data(), batch.y1.data(), n, vp, c1.data());
+
+        std::vector<Segment_2_Visual> result;
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            if (c0[i] & c1[i]) {
+                continue;
+            }
+            double x0 = batch.x0[i], y0 = batch.y0[i], x1 = batch.x1[i], y1 = batch.y1[i];
+            if ((c0[i] | c1[i]) && !clipSegment(x0, y0, x1, y1, c0[i], c1[i], vp)) {
+                continue;
+            }
+            result.push_back(Segment_2_Visual(makePoint(x0, y0, batch.sourceStyle[i]),
+                                              makePoint(x1, y1, batch.targetStyle[i]),
+                                              batch.boundaryColor[i], batch.bType[i]));
+            if (sourceIndex) {
+                sourceIndex->push_back(i);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Clip a batch of triangles against the viewport (Sutherland-Hodgman)
+     * @details Triangles inside the viewport are returned unchanged. The others are clipped and the convex polygon
+     *          is returned as a fan of triangles around its first vertex; zero-area fan triangles (the triangle only
+     *          touches the viewport, or the polygon has collinear vertices) are dropped
+     * @param batch Triangle coordinate arrays
+     * @param vp Viewport
+     * @param sourceIndex Optional; receives the batch index of every returned triangle
+     * @return Clipped triangles with the style of their input triangle
+     */
+    std::vector<Triangle_2_Visual> clip(const TriangleBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex) {
+        std::size_t n = batch.size();
+        std::vector<unsigned char> c0(n), c1(n), c2(n);
+        outcodes(batch.x0.data(), batch.y0.data(), n, vp, c0.data());
+        outcodes(batch.x1.data(), batch.y1.data(), n, vp, c1.data());
+        outcodes(batch.x2.data(), batch.y2.data(), n, vp, c2.data());
+
+        std::vector<Triangle_2_Visual> result;
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            if (c0[i] & c1[i] & c2[i]) {
+                continue;
+            }
+
+            const PointStyle* style = &batch.vertexStyle[3 * i];
+            if (!(c0[i] | c1[i] | c2[i])) {
+                // Inside: returned unchanged, even if degenerate
+                result.push_back(Triangle_2_Visual(makePoint(batch.x0[i], batch.y0[i], style[0]),
+                                                   makePoint(batch.x1[i], batch.y1[i], style[1]),
+                                                   makePoint(batch.x2[i], batch.y2[i], style[2]),
+                                                   batch.boundaryColor[i], batch.interiorColor[i], batch.bType[i]));
+                if (sourceIndex) {
+                    sourceIndex->push_back(i);
+                }
+                continue;
+            }
+
+            ClipVertex poly[MaxClipVertices] = {
+                {batch.x0[i], batch.y0[i], 0},
+                {batch.x1[i], batch.y1[i], 1},
+                {batch.x2[i], batch.y2[i], 2}
+            };
+            int m = clipPolygon(poly, 3, vp);
+            m = removeDuplicateVertices(poly, m);
+
+            for (int k = 1; k + 1 < m; k++) {
+                // A triangle touching the viewport along an edge or in a point leaves collinear vertices
+                if (cross(poly[0], poly[k], poly[k + 1]) == 0) {
+                    continue;
+                }
+                result.push_back(Triangle_2_Visual(makePoint(poly[0].x, poly[0].y, style[poly[0].origin]),
+                                                   makePoint(poly[k].x, poly[k].y, style[poly[k].origin]),
+                                                   makePoint(poly[k + 1].x, poly[k + 1].y, style[poly[k + 1].origin]),
+                                                   batch.boundaryColor[i], batch.interiorColor[i], batch.bType[i]));
+                if (sourceIndex) {
+                    sourceIndex->push_back(i);
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Clip a batch of rectangles against the viewport
+     * @param batch Rectangle coordinate arrays
+     * @param vp Viewport
+     * @param sourceIndex Optional; receives the batch index of every returned rectangle
+     * @return Clipped rectangles with the style of their input rectangle
+     */
+    std::vector<Iso_rectangle_2_Visual> clip(const RectangleBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex) {
+        std::size_t n = batch.size();
+        std::vector<double> xmin(n), ymin(n), xmax(n), ymax(n);
+        for (std::size_t i = 0; i < n; i++) {
+            xmin[i] = std::max(batch.xmin[i], vp.xmin);
+            ymin[i] = std::max(batch.ymin[i], vp.ymin);
+            xmax[i] = std::min(batch.xmax[i], vp.xmax);
+            ymax[i] = std::min(batch.ymax[i], vp.ymax);
+        }
+
+        std::vector<Iso_rectangle_2_Visual> result;
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            if (xmin[i] > xmax[i] || ymin[i] > ymax[i]) {
+                continue;
+            }
+            result.push_back(Iso_rectangle_2_Visual(makePoint(xmin[i], ymin[i], batch.minStyle[i]),
+                                                    makePoint(xmax[i], ymax[i], batch.maxStyle[i]),
+                                                    batch.boundaryColor[i], batch.interiorColor[i], batch.bType[i]));
+            if (sourceIndex) {
+                sourceIndex->push_back(i);
+            }
+        }
+        return result;
+    }
+
+// Validation against CGAL
+    // CGAL::intersection returns a boost::variant before CGAL 6 and a std::variant since
+    template <typename Visitor, typename Variant>
+    static typename Visitor::result_type visitIntersection(const Visitor& visitor, const Variant& v) {
+#if CGAL_VERSION_NR >= 1060000000
+        return std::visit(visitor, v);
+#else
+        return boost::apply_visitor(visitor, v);
+#endif
+    }
+
+    static double magnitude(const Iso_rectangle_2& rect) {
+        return std::max({std::fabs(CGAL::to_double(rect.xmin())), std::fabs(CGAL::to_double(rect.ymin())),
+                         std::fabs(CGAL::to_double(rect.xmax())), std::fabs(CGAL::to_double(rect.ymax()))});
+    }
+
+    static double magnitude(const Point_2_Visual& p) {
+        return std::max(std::fabs(CGAL::to_double(p.x())), std::fabs(CGAL::to_double(p.y())));
+    }
+
+    // Compare a clipped segment (nullptr if it was dropped) with the intersection computed by CGAL
+    struct SegmentCheck {
+        typedef bool result_type;
+
+        const Segment_2_Visual* clipped;
+        double tolerance;
+
+        bool near(const Point_2_Visual& a, const Point_2& b) const {
+            return std::fabs(CGAL::to_double(a.x()) - CGAL::to_double(b.x())) <= tolerance
+                    && std::fabs(CGAL::to_double(a.y()) - CGAL::to_double(b.y())) <= tolerance;
+        }
+
+        bool operator()(const Point_2& p) const {
+            return clipped && near(clipped->source(), p) && near(clipped->target(), p);
+        }
+
+        bool operator()(const Segment_2& seg) const {
+            return clipped
+                    && ((near(clipped->source(), seg.source()) && near(clipped->target(), seg.target()))
+                        || (near(clipped->source(), seg.target()) && near(clipped->target(), seg.source())));
+        }
+    };
+
+    // Area of the intersection of a triangle and a rectangle computed by CGAL
+    struct IntersectionArea {
+        typedef double result_type;
+
+        double operator()(const Point_2&) const { return 0; }
+        double operator()(const Segment_2&) const { return 0; }
+        double operator()(const Triangle_2& tri) const { return std::fabs(CGAL::to_double(tri.area())); }
+
+        double operator()(const std::vector<Point_2>& poly) const {
+            double area = 0;
+            for (std::size_t i = 0; i < poly.size(); i++) {
+                const Point_2& a = poly[i];
+                const Point_2& b = poly[(i + 1) % poly.size()];
+                area += CGAL::to_double(a.x()) * CGAL::to_double(b.y()) - CGAL::to_double(b.x()) * CGAL::to_double(a.y());
+            }
+            return std::fabs(area) / 2;
+        }
+    };
+
+    /**
+     * @brief Check clipped segments against CGAL::intersection
+     * @details A segment matches if both are empty, or if its clipped endpoints equal the intersection's
+     *          (a point intersection must give a degenerate segment on that point)
+     * @return Number of segments that do not match
+     */
+    std::size_t countClipMismatches(const std::vector<Segment_2_Visual>& segments, const Iso_rectangle_2& viewport) {
+        std::vector<std::size_t> sourceIndex;
+        std::vector<Segment_2_Visual> clipped = clip(toBatch(segments), toViewport(viewport), &sourceIndex);
+
+        std::vector<const Segment_2_Visual*> result(segments.size(), nullptr);
+        for (std::size_t k = 0; k < clipped.size(); k++) {
+            result[sourceIndex[k]] = &clipped[k];
+        }
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < segments.size(); i++) {
+            auto expected = CGAL::intersection(segments[i].KernelObject(), viewport);
+            double scale = 1 + std::max({magnitude(viewport), magnitude(segments[i].source()), magnitude(segments[i].target())});
+            bool ok = expected ? visitIntersection(SegmentCheck{result[i], 1e-9 * scale}, *expected) : result[i] == nullptr;
+            if (!ok) {
+                mismatches++;
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief Check clipped triangles against CGAL::intersection
+     * @details A triangle inside the viewport must be returned once and unchanged, even if degenerate.
+     *          Otherwise the returned fan must consist of non-degenerate triangles inside the viewport, and its area
+     *          must equal the area of the intersection; triangles that only touch the viewport must be dropped
+     * @return Number of triangles that do not match
+     */
+    std::size_t countClipMismatches(const std::vector<Triangle_2_Visual>& triangles, const Iso_rectangle_2& viewport) {
+        std::vector<std::size_t> sourceIndex;
+        std::vector<Triangle_2_Visual> clipped = clip(toBatch(triangles), toViewport(viewport), &sourceIndex);
+
+        std::vector<bool> inside(triangles.size());
+        for (std::size_t i = 0; i < triangles.size(); i++) {
+            Triangle_2 tri = triangles[i].KernelObject();
+            inside[i] = !viewport.has_on_unbounded_side(tri[0]) && !viewport.has_on_unbounded_side(tri[1])
+                    && !viewport.has_on_unbounded_side(tri[2]);
+        }
+
+        // Every returned triangle must be its inside source, or have a positive area and lie inside the viewport
+        std::vector<double> area(triangles.size(), 0.0);
+        std::vector<std::size_t> returned(triangles.size(), 0);
+        std::vector<bool> invalid(triangles.size(), false);
+        for (std::size_t k = 0; k < clipped.size(); k++) {
+            std::size_t i = sourceIndex[k];
+            Triangle_2 tri = clipped[k].KernelObject();
+            double a = std::fabs(CGAL::to_double(tri.area()));
+            area[i] += a;
+            returned[i]++;
+            if (inside[i]) {
+                Triangle_2 source = triangles[i].KernelObject();
+                if (!(tri[0] == source[0] && tri[1] == source[1] && tri[2] == source[2])) {
+                    invalid[i] = true;
+                }
+            } else if (a == 0 || viewport.has_on_unbounded_side(tri[0]) || viewport.has_on_unbounded_side(tri[1])
+                    || viewport.has_on_unbounded_side(tri[2])) {
+                invalid[i] = true;
+            }
+        }
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < triangles.size(); i++) {
+            if (inside[i] && returned[i] != 1) {
+                invalid[i] = true;
+            }
+            auto expected = CGAL::intersection(triangles[i].KernelObject(), viewport);
+            double expectedArea = expected ? visitIntersection(IntersectionArea(), *expected) : 0.0;
+            double scale = 1 + std::max({magnitude(viewport), magnitude(triangles[i].vertex(0)),
+                                         magnitude(triangles[i].vertex(1)), magnitude(triangles[i].vertex(2))});
+            if (invalid[i] || std::fabs(area[i] - expectedArea) > 1e-9 * scale * scale) {
+                mismatches++;
+            }
+        }
+        return mismatches;
+    }
+
+    /**
+     * @brief Check clipped rectangles against CGAL::do_intersect
+     * @details The clipped corners are exact (min/max of the input coordinates), so only the kept/dropped decision is checked
+     * @return Number of rectangles that do not match
+     */
+    std::size_t countClipMismatches(const std::vector<Iso_rectangle_2_Visual>& rectangles, const Iso_rectangle_2& viewport) {
+        std::vector<std::size_t> sourceIndex;
+        clip(toBatch(rectangles), toViewport(viewport), &sourceIndex);
+
+        std::vector<bool> kept(rectangles.size(), false);
+        for (std::size_t i : sourceIndex) {
+            kept[i] = true;
+        }
+
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < rectangles.size(); i++) {
+            if (kept[i] != CGAL::do_intersect(rectangles[i].KernelObject(), viewport)) {
+                mismatches++;
+            }
+        }
+        return mismatches;
+    }
+
+} // namespace Geo2Util
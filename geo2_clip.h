@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "geo2_util.h"
+
+namespace Geo2Util {
+
+    // Batched viewport clipping
+    // Shapes are flattened into coordinate arrays (one array per coordinate) so the
+    // outcode pass walks contiguous doubles and is vectorized by the compiler.
+    // Visual properties are kept next to the coordinates by index and copied onto the clipped shapes.
+        // segments: Cohen-Sutherland
+        // triangles: Sutherland-Hodgman, the clipped convex polygon is returned as a triangle fan
+        // rectangles: min/max intersection
+
+    struct Viewport {
+        double xmin;
+        double ymin;
+        double xmax;
+        double ymax;
+    };
+    Viewport toViewport(const Iso_rectangle_2& rect);
+
+    // Visual properties of a single vertex (Point_2_Visual)
+    struct PointStyle {
+        Color boundaryColor;
+        Color interiorColor;
+        BoundaryType bType;
+    };
+
+    struct SegmentBatch {
+        std::vector<double> x0, y0, x1, y1;
+
+        std::vector<Color> boundaryColor;
+        std::vector<BoundaryType> bType;
+        std::vector<PointStyle> sourceStyle;
+        std::vector<PointStyle> targetStyle;
+
+        std::size_t size() const { return x0.size(); }
+    };
+
+    struct TriangleBatch {
+        std::vector<double> x0, y0, x1, y1, x2, y2;
+
+        std::vector<Color> boundaryColor;
+        std::vector<Color> interiorColor;
+        std::vector<BoundaryType> bType;
+        std::vector<PointStyle> vertexStyle; // 3 entries per triangle
+
+        std::size_t size() const { return x0.size(); }
+    };
+
+    struct RectangleBatch {
+        std::vector<double> xmin, ymin, xmax, ymax;
+
+        std::vector<Color> boundaryColor;
+        std::vector<Color> interiorColor;
+        std::vector<BoundaryType> bType;
+        std::vector<PointStyle> minStyle;
+        std::vector<PointStyle> maxStyle;
+
+        std::size_t size() const { return xmin.size(); }
+    };
+
+    // Extract coordinate arrays from the visual wrappers
+    SegmentBatch toBatch(const std::vector<Segment_2_Visual>& segments);
+    TriangleBatch toBatch(const std::vector<Triangle_2_Visual>& triangles);
+    RectangleBatch toBatch(const std::vector<Iso_rectangle_2_Visual>& rectangles);
+
+    // Clip a batch against the viewport
+    // If sourceIndex is given, it receives the batch index of the input shape for every output shape
+    std::vector<Segment_2_Visual> clip(const SegmentBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex = nullptr);
+    std::vector<Triangle_2_Visual> clip(const TriangleBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex = nullptr);
+    std::vector<Iso_rectangle_2_Visual> clip(const RectangleBatch& batch, const Viewport& vp, std::vector<std::size_t>* sourceIndex = nullptr);
+
+    // Outcode implementation compiled in: "SSE2" or "scalar"
+    const char* outcodePath();
+
+    // Validation against CGAL
+    // Return the number of shapes whose clipped geometry disagrees with CGAL:
+    // segments compare endpoints and triangles compare area with CGAL::intersection,
+    // rectangles (whose clipped corners are exact) compare the kept/dropped decision with CGAL::do_intersect
+    std::size_t countClipMismatches(const std::vector<Segment_2_Visual>& segments, const Iso_rectangle_2& viewport);
+    std::size_t countClipMismatches(const std::vector<Triangle_2_Visual>& triangles, const Iso_rectangle_2& viewport);
+    std::size_t countClipMismatches(const std::vector<Iso_rectangle_2_Visual>& rectangles, const Iso_rectangle_2& viewport);
+} // namespace Geo2Util
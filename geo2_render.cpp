@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "geo2_render.h"
+
+namespace Geo2Util {
+
+// SVG output
+    static std::string svgStroke(const Color& color, const BoundaryType& bt) {
+        std::string s = "stroke=\"rgb(" + std::to_string(color.r) + "," + std::to_string(color.g) + "," + std::to_string(color.b) + ")\""
+                + " stroke-opacity=\"" + std::to_string(color.trans / 255.0) + "\""
+                + " stroke-width=\"1\" vector-effect=\"non-scaling-stroke\"";
+        switch (bt) {
+            case BoundaryType::Dotted : return s + " stroke-dasharray=\"1 3\"";
+            case BoundaryType::Dashed : return s + " stroke-dasharray=\"6 3\"";
+            default: return s;
+        }
+    }
+
+    static std::string svgFill(const Color& color) {
+        return "fill=\"rgb(" + std::to_string(color.r) + "," + std::to_string(color.g) + "," + std::to_string(color.b) + ")\""
+                + " fill-opacity=\"" + std::to_string(color.trans / 255.0) + "\"";
+    }
+
+    /**
+     * @brief Write a scene as an SVG document
+     * @param filename Output file
+     * @param scene Scene
+     * @param view Part of the plane mapped to the SVG viewBox
+     */
+    void writeSvg(const std::string& filename, const Scene& scene, const Viewport& view) {
+        std::ofstream out(filename);
+        if (!out) {
+            throw std::runtime_error(filename + ": cannot open file for writing");
+        }
+
+        double w = std::max(view.xmax - view.xmin, 1e-9);
+        double h = std::max(view.ymax - view.ymin, 1e-9);
+        double pointRadius = 0.005 * std::max(w, h);
+
+        // Flipping y maps [ymin, ymax] to [-ymax, -ymin]
+        out << std::fixed << std::setprecision(10);
+        out << "<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\""
+            << view.xmin << " " << -view.ymax << " " << w << " " << h << "\">\n"
+            << "<g transform=\"scale(1,-1)\">\n";
+
+        for (const Iso_rectangle_2_Visual& rectv : scene.rectangles) {
+            Iso_rectangle_2 rect = rectv.KernelObject();
+            out << "<rect x=\"" << rect.xmin() << "\" y=\"" << rect.ymin()
+                << "\" width=\"" << rect.xmax() - rect.xmin() << "\" height=\"" << rect.ymax() - rect.ymin() << "\" "
+                << svgFill(rectv.getInteriorColor()) << " " << svgStroke(rectv.getBondaryColor(), rectv.getBoundaryType()) << "/>\n";
+        }
+        for (const Triangle_2_Visual& triv : scene.triangles) {
+            out << "<polygon points=\"";
+            for (int i = 0; i < 3; i++) {
+                out << (i ? " " : "") << triv.vertex(i).x() << "," << triv.vertex(i).y();
+            }
+            out << "\" " << svgFill(triv.getInteriorColor()) << " " << svgStroke(triv.getBondaryColor(), triv.getBoundaryType()) << "/>\n";
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            out << "<circle cx=\"" << circv.center().x() << "\" cy=\"" << circv.center().y()
+                << "\" r=\"" << std::sqrt(CGAL::to_double(circv.squared_radius())) << "\" "
+                << svgFill(circv.getInteriorColor()) << " " << svgStroke(circv.getBondaryColor(), circv.getBoundaryType()) << "/>\n";
+        }
+        for (const Segment_2_Visual& segv : scene.segments) {
+            out << "<line x1=\"" << segv.source().x() << "\" y1=\"" << segv.source().y()
+                << "\" x2=\"" << segv.target().x() << "\" y2=\"" << segv.target().y() << "\" "
+                << svgStroke(segv.getBondaryColor(), segv.getBoundaryType()) << "/>\n";
+        }
+        for (const Point_2_Visual& pv : scene.points) {
+            out << "<circle cx=\"" << pv.x() << "\" cy=\"" << pv.y() << "\" r=\"" << pointRadius << "\" "
+                << svgFill(pv.getInteriorColor()) << " " << svgStroke(pv.getBondaryColor(), pv.getBoundaryType()) << "/>\n";
+        }
+
+        out << "</g>\n</svg>\n";
+        if (!out) {
+            throw std::runtime_error(filename + ": write failed");
+        }
+    }
+
+// Raster output
+    // RGB canvas; world coordinates are mapped to pixels with a uniform scale, centered, y pointing up
+    class Canvas {
+    private:
+        int m_width;
+        int m_height;
+        std::vector<unsigned char> m_rgb;
+
+        double m_scale;
+        double m_offsetX;
+        double m_offsetY;
+    public:
+        Canvas(int width, int height, const Viewport& view)
+            : m_width(width)
+                , m_height(height)
+                , m_rgb(3 * static_cast<std::size_t>(width) * height, 255) {
+            double w = std::max(view.xmax - view.xmin, 1e-9);
+            double h = std::max(view.ymax - view.ymin, 1e-9);
+            m_scale = std::min(width / w, height / h);
+            m_offsetX = (width - w * m_scale) / 2 - view.xmin * m_scale;
+            m_offsetY = (height - h * m_scale) / 2 - view.ymin * m_scale;
+        }
+
+        double px(double x) const { return x * m_scale + m_offsetX; }
+        double py(double y) const { return m_height - (y * m_scale + m_offsetY); }
+        double scale() const { return m_scale; }
+
+        // Alpha blend color into pixel (x, y); trans is the opacity in [0, 255]
+        void blend(int x, int y, const Color& color) {
+            if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+                return;
+            }
+            double a = std::min(std::max(color.trans / 255.0, 0.0), 1.0);
+            unsigned char* p = &m_rgb[3 * (static_cast<std::size_t>(y) * m_width + x)];
+            const short c[3] = {color.r, color.g, color.b};
+            for (int i = 0; i < 3; i++) {
+                double v = p[i] + (std::min(std::max<int>(c[i], 0), 255) - p[i]) * a;
+                p[i] = static_cast<unsigned char>(std::lround(v));
+            }
+        }
+
+        // Pixel range [first, last] covering [lo, hi], clamped to [0, size - 1]
+        static bool span(double lo, double hi, int size, int& first, int& last) {
+            first = static_cast<int>(std::min(std::max(std::ceil(lo - 0.5), 0.0), static_cast<double>(size)));
+            last = static_cast<int>(std::max(std::min(std::floor(hi - 0.5), size - 1.0), -1.0));
+            return first <= last;
+        }
+
+        void fillRect(double x0, double y0, double x1, double y1, const Color& color) {
+            int fx, lx, fy, ly;
+            if (!span(std::min(px(x0), px(x1)), std::max(px(x0), px(x1)), m_width, fx, lx)
+                    || !span(std::min(py(y0), py(y1)), std::max(py(y0), py(y1)), m_height, fy, ly)) {
+                return;
+            }
+            for (int y = fy; y <= ly; y++) {
+                for (int x = fx; x <= lx; x++) {
+                    blend(x, y, color);
+                }
+            }
+        }
+
+        void fillTriangle(double ax, double ay, double bx, double by, double cx, double cy, const Color& color) {
+            ax = px(ax); bx = px(bx); cx = px(cx);
+            ay = py(ay); by = py(by); cy = py(cy);
+            double area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+            if (area == 0) {
+                return;
+            }
+            int fx, lx, fy, ly;
+            if (!span(std::min({ax, bx, cx}), std::max({ax, bx, cx}), m_width, fx, lx)
+                    || !span(std::min({ay, by, cy}), std::max({ay, by, cy}), m_height, fy, ly)) {
+                return;
+            }
+            double sign = area > 0 ? 1 : -1;
+            for (int y = fy; y <= ly; y++) {
+                double sy = y + 0.5;
+                for (int x = fx; x <= lx; x++) {
+                    double sx = x + 0.5;
+                    double e0 = ((bx - ax) * (sy - ay) - (by - ay) * (sx - ax)) * sign;
+                    double e1 = ((cx - bx) * (sy - by) - (cy - by) * (sx - bx)) * sign;
+                    double e2 = ((ax - cx) * (sy - cy) - (ay - cy) * (sx - cx)) * sign;
+                    if (e0 >= 0 && e1 >= 0 && e2 >= 0) {
+                        blend(x, y, color);
+                    }
+                }
+            }
+        }
+
+        void fillCircle(double cx, double cy, double r, const Color& color) {
+            cx = px(cx);
+            cy = py(cy);
+            r *= m_scale;
+            int fx, lx, fy, ly;
+            if (!span(cx - r, cx + r, m_width, fx, lx) || !span(cy - r, cy + r, m_height, fy, ly)) {
+                return;
+            }
+            for (int y = fy; y <= ly; y++) {
+                double dy = y + 0.5 - cy;
+                for (int x = fx; x <= lx; x++) {
+                    double dx = x + 0.5 - cx;
+                    if (dx * dx + dy * dy <= r * r) {
+                        blend(x, y, color);
+                    }
+                }
+            }
+        }
+
+        // Line in world coordinates, clipped to the canvas (Liang-Barsky) before stepping
+        void drawLine(double x0, double y0, double x1, double y1, const Color& color, const BoundaryType& bt) {
+            x0 = px(x0); y0 = py(y0); x1 = px(x1); y1 = py(y1);
+            double dx = x1 - x0, dy = y1 - y0;
+            double t0 = 0, t1 = 1;
+            const double p[4] = {-dx, dx, -dy, dy};
+            const double q[4] = {x0, m_width - 1 - x0, y0, m_height - 1 - y0};
+            for (int i = 0; i < 4; i++) {
+                if (p[i] == 0) {
+                    if (q[i] < 0) {
+                        return;
+                    }
+                } else {
+                    double t = q[i] / p[i];
+                    if (p[i] < 0) {
+                        t0 = std::max(t0, t);
+                    } else {
+                        t1 = std::min(t1, t);
+                    }
+                }
+            }
+            if (t0 > t1) {
+                return;
+            }
+
+            double sx = x0 + t0 * dx, sy = y0 + t0 * dy;
+            double ex = x0 + t1 * dx, ey = y0 + t1 * dy;
+            // Non-finite input coordinates leave NaN endpoints; otherwise the clipped line is at most the canvas diagonal
+            double length = std::max(std::fabs(ex - sx), std::fabs(ey - sy));
+            if (!std::isfinite(length)) {
+                return;
+            }
+            int steps = static_cast<int>(std::ceil(length));
+            for (int i = 0; i <= steps; i++) {
+                if ((bt == BoundaryType::Dotted && i % 4 != 0) || (bt == BoundaryType::Dashed && i % 9 >= 6)) {
+                    continue;
+                }
+                double t = steps ? static_cast<double>(i) / steps : 0;
+                blend(static_cast<int>(std::lround(sx + t * (ex - sx))), static_cast<int>(std::lround(sy + t * (ey - sy))), color);
+            }
+        }
+
+        void drawCircle(double cx, double cy, double r, const Color& color, const BoundaryType& bt) {
+            // Clamped in double, r * m_scale can exceed the int range
+            int n = static_cast<int>(std::min(4096.0, std::max(16.0, r * m_scale)));
+            const double pi = 3.14159265358979323846;
+            for (int i = 0; i < n; i++) {
+                double a0 = 2 * pi * i / n, a1 = 2 * pi * (i + 1) / n;
+                drawLine(cx + r * std::cos(a0), cy + r * std::sin(a0), cx + r * std::cos(a1), cy + r * std::sin(a1), color, bt);
+            }
+        }
+
+        void write(std::ostream& out) const {
+            out << "P6\n" << m_width << " " << m_height << "\n255\n";
+            out.write(reinterpret_cast<const char*>(m_rgb.data()), m_rgb.size());
+        }
+    };
+
+    /**
+     * @brief Write a scene as a binary PPM image
+     * @param filename Output file
+     * @param scene Scene
+     * @param view Part of the plane drawn into the image
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     */
+    void writePpm(const std::string& filename, const Scene& scene, const Viewport& view, int width, int height) {
+        if (width <= 0 || height <= 0) {
+            throw std::runtime_error(filename + ": invalid image size");
+        }
+        Canvas canvas(width, height, view);
+
+        for (const Iso_rectangle_2_Visual& rectv : scene.rectangles) {
+            Iso_rectangle_2 rect = rectv.KernelObject();
+            double x0 = CGAL::to_double(rect.xmin()), y0 = CGAL::to_double(rect.ymin());
+            double x1 = CGAL::to_double(rect.xmax()), y1 = CGAL::to_double(rect.ymax());
+            canvas.fillRect(x0, y0, x1, y1, rectv.getInteriorColor());
+            canvas.drawLine(x0, y0, x1, y0, rectv.getBondaryColor(), rectv.getBoundaryType());
+            canvas.drawLine(x1, y0, x1, y1, rectv.getBondaryColor(), rectv.getBoundaryType());
+            canvas.drawLine(x1, y1, x0, y1, rectv.getBondaryColor(), rectv.getBoundaryType());
+            canvas.drawLine(x0, y1, x0, y0, rectv.getBondaryColor(), rectv.getBoundaryType());
+        }
+        for (const Triangle_2_Visual& triv : scene.triangles) {
+            double x[3], y[3];
+            for (int i = 0; i < 3; i++) {
+                x[i] = CGAL::to_double(triv.vertex(i).x());
+                y[i] = CGAL::to_double(triv.vertex(i).y());
+            }
+            canvas.fillTriangle(x[0], y[0], x[1], y[1], x[2], y[2], triv.getInteriorColor());
+            for (int i = 0; i < 3; i++) {
+                canvas.drawLine(x[i], y[i], x[(i + 1) % 3], y[(i + 1) % 3], triv.getBondaryColor(), triv.getBoundaryType());
+            }
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            double cx = CGAL::to_double(circv.center().x());
+            double cy = CGAL::to_double(circv.center().y());
+            double r = std::sqrt(CGAL::to_double(circv.squared_radius()));
+            canvas.fillCircle(cx, cy, r, circv.getInteriorColor());
+            canvas.drawCircle(cx, cy, r, circv.getBondaryColor(), circv.getBoundaryType());
+        }
+        for (const Segment_2_Visual& segv : scene.segments) {
+            canvas.drawLine(CGAL::to_double(segv.source().x()), CGAL::to_double(segv.source().y()),
+                            CGAL::to_double(segv.target().x()), CGAL::to_double(segv.target().y()),
+                            segv.getBondaryColor(), segv.getBoundaryType());
+        }
+        for (const Point_2_Visual& pv : scene.points) {
+            double r = 1.5 / canvas.scale();
+            canvas.fillCircle(CGAL::to_double(pv.x()), CGAL::to_double(pv.y()), r, pv.getInteriorColor());
+        }
+
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error(filename + ": cannot open file for writing");
+        }
+        canvas.write(out);
+        if (!out) {
+            throw std::runtime_error(filename + ": write failed");
+        }
+    }
+
+} // namespace Geo2Util
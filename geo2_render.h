@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+
+#include "geo2_scene.h"
+
+namespace Geo2Util {
+
+    // Rendered outputs; the view is the part of the plane that is drawn (usually the viewport or the scene bounding box)
+    // Shapes are drawn by type: rectangles, triangles, circles, segments, points
+    // Throw std::runtime_error if the file cannot be written
+
+    // SVG document with the y axis pointing up
+    void writeSvg(const std::string& filename, const Scene& scene, const Viewport& view);
+
+    // Binary PPM (P6) image of width x height pixels on a white background; the view is scaled uniformly to fit
+    void writePpm(const std::string& filename, const Scene& scene, const Viewport& view, int width, int height);
+} // namespace Geo2Util
@@ -0,0 +1,631 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "geo2_scene.h"
+
+namespace Geo2Util {
+
+    // Binary layout (host byte order, little-endian on all supported platforms):
+    //   header: magic "G2DB", uint32 version, uint32 shard id, uint32 shard count,
+    //           uint64 count and uint64 byte offset per shape type (points, segments, circles, triangles, rectangles),
+    //           bounding box (4 x double), uint64 number of index entries, index entries
+    //   index entry: uint32 shard id, uint64 count and uint64 first record per shape type, bounding box
+    //   followed by the fixed-size records of each type in the same order
+    // color: 4 x int16 (r, g, b, trans); boundary type: int16; coordinates: double
+    const char BinaryMagic[4] = {'G', '2', 'D', 'B'};
+    const std::uint32_t BinaryVersion = 2;
+    const std::uint64_t BinaryHeaderSize = 4 + 4 + 4 + 4 + 5 * 8 + 5 * 8 + 4 * 8 + 8;
+    const std::uint64_t BinaryIndexEntrySize = 4 + 5 * 8 + 5 * 8 + 4 * 8;
+
+    std::size_t Scene::size() const {
+        return points.size() + segments.size() + circles.size() + triangles.size() + rectangles.size();
+    }
+
+    static void extend(Viewport& box, const Point_2_Visual& p) {
+        double x = CGAL::to_double(p.x());
+        double y = CGAL::to_double(p.y());
+        box.xmin = std::min(box.xmin, x);
+        box.ymin = std::min(box.ymin, y);
+        box.xmax = std::max(box.xmax, x);
+        box.ymax = std::max(box.ymax, y);
+    }
+
+    /**
+     * @brief Compute the bounding box of all shapes in a scene
+     * @param scene Scene
+     * @return Bounding box; xmin > xmax if the scene is empty
+     */
+    Viewport boundingBox(const Scene& scene) {
+        const double inf = std::numeric_limits<double>::infinity();
+        Viewport box{inf, inf, -inf, -inf};
+
+        for (const Point_2_Visual& pv : scene.points) {
+            extend(box, pv);
+        }
+        for (const Segment_2_Visual& segv : scene.segments) {
+            extend(box, segv.source());
+            extend(box, segv.target());
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            double r = std::sqrt(CGAL::to_double(circv.squared_radius()));
+            double x = CGAL::to_double(circv.center().x());
+            double y = CGAL::to_double(circv.center().y());
+            box.xmin = std::min(box.xmin, x - r);
+            box.ymin = std::min(box.ymin, y - r);
+            box.xmax = std::max(box.xmax, x + r);
+            box.ymax = std::max(box.ymax, y + r);
+        }
+        for (const Triangle_2_Visual& triv : scene.triangles) {
+            extend(box, triv.vertex(0));
+            extend(box, triv.vertex(1));
+            extend(box, triv.vertex(2));
+        }
+        for (const Iso_rectangle_2_Visual& rectv : scene.rectangles) {
+            extend(box, rectv.min());
+            extend(box, rectv.max());
+        }
+        return box;
+    }
+
+// Text input: the format written by toString(KernelObject_Visual)
+    static BoundaryType toBoundaryType(int bt, const std::string& filename) {
+        if (bt < 0 || bt > 2) {
+            throw std::runtime_error(filename + ": invalid boundary type " + std::to_string(bt));
+        }
+        return static_cast<BoundaryType>(bt);
+    }
+
+    static Color readColor(std::istream& in) {
+        Color color;
+        in >> color.r >> color.g >> color.b >> color.trans;
+        return color;
+    }
+
+    static BoundaryType readBoundaryType(std::istream& in, const std::string& filename) {
+        int bt = 0;
+        in >> bt;
+        return toBoundaryType(bt, filename);
+    }
+
+    // "x y boundaryColor boundaryType interiorColor", following the POINT keyword
+    static Point_2_Visual readPointFields(std::istream& in, const std::string& filename) {
+        double x = 0, y = 0;
+        in >> x >> y;
+        Color boundaryColor = readColor(in);
+        BoundaryType btype = readBoundaryType(in, filename);
+        Color interiorColor = readColor(in);
+        return Point_2_Visual(Point_2(x, y), boundaryColor, interiorColor, btype);
+    }
+
+    // Vertex of a shape: "POINT x y boundaryColor boundaryType interiorColor"
+    static Point_2_Visual readPointRecord(std::istream& in, const std::string& filename) {
+        std::string keyword;
+        in >> keyword;
+        if (keyword != "POINT") {
+            throw std::runtime_error(filename + ": expected POINT, found \"" + keyword + "\"");
+        }
+        return readPointFields(in, filename);
+    }
+
+    /**
+     * @brief Read a scene written by writeText (or printToFile with toString records)
+     * @param filename Input file
+     * @return Scene
+     */
+    Scene readText(const std::string& filename) {
+        std::ifstream in(filename);
+        if (!in) {
+            throw std::runtime_error(filename + ": cannot open file");
+        }
+
+        Scene scene;
+        std::string keyword;
+        while (in >> keyword) {
+            if (keyword == "POINT") {
+                scene.points.push_back(readPointFields(in, filename));
+            } else if (keyword == "LINE_SEGMENT") {
+                Color boundaryColor = readColor(in);
+                BoundaryType btype = readBoundaryType(in, filename);
+                Point_2_Visual s = readPointRecord(in, filename);
+                Point_2_Visual t = readPointRecord(in, filename);
+                scene.segments.push_back(Segment_2_Visual(s, t, boundaryColor, btype));
+            } else if (keyword == "CIRCLE") {
+                double radius = 0;
+                in >> radius;
+                Color boundaryColor = readColor(in);
+                BoundaryType btype = readBoundaryType(in, filename);
+                Color interiorColor = readColor(in);
+                Point_2_Visual center = readPointRecord(in, filename);
+                scene.circles.push_back(Circle_2_Visual(center, radius * radius, boundaryColor, interiorColor, btype));
+            } else if (keyword == "TRIANGLE") {
+                Color boundaryColor = readColor(in);
+                BoundaryType btype = readBoundaryType(in, filename);
+                Color interiorColor = readColor(in);
+                Point_2_Visual p = readPointRecord(in, filename);
+                Point_2_Visual q = readPointRecord(in, filename);
+                Point_2_Visual r = readPointRecord(in, filename);
+                scene.triangles.push_back(Triangle_2_Visual(p, q, r, boundaryColor, interiorColor, btype));
+            } else if (keyword == "RECTANGLE") {
+                Color boundaryColor = readColor(in);
+                BoundaryType btype = readBoundaryType(in, filename);
+                Color interiorColor = readColor(in);
+                Point_2_Visual p = readPointRecord(in, filename);
+                Point_2_Visual q = readPointRecord(in, filename);
+                scene.rectangles.push_back(Iso_rectangle_2_Visual(p, q, boundaryColor, interiorColor, btype));
+            } else {
+                throw std::runtime_error(filename + ": unknown record \"" + keyword + "\"");
+            }
+
+            if (in.fail()) {
+                throw std::runtime_error(filename + ": malformed " + keyword + " record");
+            }
+        }
+        return scene;
+    }
+
+// Binary input/output
+    template <typename T>
+    static void writePod(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static T readPod(std::istream& in) {
+        T value{};
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+    }
+
+    static void writeColor(std::ostream& out, const Color& color) {
+        writePod<std::int16_t>(out, color.r);
+        writePod<std::int16_t>(out, color.g);
+        writePod<std::int16_t>(out, color.b);
+        writePod<std::int16_t>(out, color.trans);
+    }
+
+    static Color readBinaryColor(std::istream& in) {
+        Color color;
+        color.r = readPod<std::int16_t>(in);
+        color.g = readPod<std::int16_t>(in);
+        color.b = readPod<std::int16_t>(in);
+        color.trans = readPod<std::int16_t>(in);
+        return color;
+    }
+
+    static void writeBoundaryType(std::ostream& out, const BoundaryType& bt) {
+        writePod<std::int16_t>(out, static_cast<std::int16_t>(bt));
+    }
+
+    static void writePoint(std::ostream& out, const Point_2_Visual& pv) {
+        writePod<double>(out, CGAL::to_double(pv.x()));
+        writePod<double>(out, CGAL::to_double(pv.y()));
+        writeColor(out, pv.getBondaryColor());
+        writeBoundaryType(out, pv.getBoundaryType());
+        writeColor(out, pv.getInteriorColor());
+    }
+
+    static Point_2_Visual readBinaryPoint(std::istream& in, const std::string& filename) {
+        double x = readPod<double>(in);
+        double y = readPod<double>(in);
+        Color boundaryColor = readBinaryColor(in);
+        BoundaryType btype = toBoundaryType(readPod<std::int16_t>(in), filename);
+        Color interiorColor = readBinaryColor(in);
+        return Point_2_Visual(Point_2(x, y), boundaryColor, interiorColor, btype);
+    }
+
+    std::uint64_t binaryRecordSize(int shapeType) {
+        const std::uint64_t color = 4 * 2, btype = 2, point = 2 * 8 + color + btype + color;
+        switch (shapeType) {
+            case 0 : return point;
+            case 1 : return color + btype + 2 * point;
+            case 2 : return 8 + color + btype + color + point;
+            case 3 : return color + btype + color + 3 * point;
+            case 4 : return color + btype + color + 2 * point;
+            default: return 0;
+        }
+    }
+
+    std::uint64_t binaryHeaderSize(std::size_t indexEntries) {
+        return BinaryHeaderSize + indexEntries * BinaryIndexEntrySize;
+    }
+
+    static void writeBox(std::ostream& out, const Viewport& box) {
+        writePod<double>(out, box.xmin);
+        writePod<double>(out, box.ymin);
+        writePod<double>(out, box.xmax);
+        writePod<double>(out, box.ymax);
+    }
+
+    static Viewport readBox(std::istream& in) {
+        Viewport box;
+        box.xmin = readPod<double>(in);
+        box.ymin = readPod<double>(in);
+        box.xmax = readPod<double>(in);
+        box.ymax = readPod<double>(in);
+        return box;
+    }
+
+    /**
+     * @brief Read the header of a binary file
+     * @param in Stream positioned at the start of the file
+     * @param filename File name used in error messages
+     * @return Header
+     */
+    BinaryHeader readBinaryHeader(std::istream& in, const std::string& filename) {
+        char magic[4] = {};
+        in.read(magic, sizeof(magic));
+        if (!in || std::memcmp(magic, BinaryMagic, sizeof(magic)) != 0) {
+            throw std::runtime_error(filename + ": not a binary scene file");
+        }
+
+        BinaryHeader header;
+        header.version = readPod<std::uint32_t>(in);
+        if (header.version != BinaryVersion) {
+            throw std::runtime_error(filename + ": unsupported binary version " + std::to_string(header.version));
+        }
+        header.shardId = readPod<std::uint32_t>(in);
+        header.shardCount = readPod<std::uint32_t>(in);
+        for (std::uint64_t& count : header.counts) {
+            count = readPod<std::uint64_t>(in);
+        }
+        for (std::uint64_t& offset : header.offsets) {
+            offset = readPod<std::uint64_t>(in);
+        }
+        header.bbox = readBox(in);
+        std::uint64_t entries = readPod<std::uint64_t>(in);
+        for (std::uint64_t i = 0; i < entries && in; i++) {
+            ShardIndexEntry entry;
+            entry.shardId = readPod<std::uint32_t>(in);
+            for (std::uint64_t& count : entry.counts) {
+                count = readPod<std::uint64_t>(in);
+            }
+            for (std::uint64_t& first : entry.first) {
+                first = readPod<std::uint64_t>(in);
+            }
+            entry.bbox = readBox(in);
+            header.index.push_back(entry);
+        }
+
+        if (!in) {
+            throw std::runtime_error(filename + ": truncated header");
+        }
+        return header;
+    }
+
+    /**
+     * @brief Write the header of a binary file
+     * @details Sets the version and computes the section offsets from the counts and the index size
+     * @param out Stream positioned at the start of the file
+     * @param header Header
+     */
+    void writeBinaryHeader(std::ostream& out, BinaryHeader& header) {
+        header.version = BinaryVersion;
+        header.offsets[0] = binaryHeaderSize(header.index.size());
+        for (int t = 1; t < ShapeTypeCount; t++) {
+            header.offsets[t] = header.offsets[t - 1] + header.counts[t - 1] * binaryRecordSize(t - 1);
+        }
+
+        out.write(BinaryMagic, sizeof(BinaryMagic));
+        writePod<std::uint32_t>(out, header.version);
+        writePod<std::uint32_t>(out, header.shardId);
+        writePod<std::uint32_t>(out, header.shardCount);
+        for (std::uint64_t count : header.counts) {
+            writePod<std::uint64_t>(out, count);
+        }
+        for (std::uint64_t offset : header.offsets) {
+            writePod<std::uint64_t>(out, offset);
+        }
+        writeBox(out, header.bbox);
+        writePod<std::uint64_t>(out, header.index.size());
+        for (const ShardIndexEntry& entry : header.index) {
+            writePod<std::uint32_t>(out, entry.shardId);
+            for (std::uint64_t count : entry.counts) {
+                writePod<std::uint64_t>(out, count);
+            }
+            for (std::uint64_t first : entry.first) {
+                writePod<std::uint64_t>(out, first);
+            }
+            writeBox(out, entry.bbox);
+        }
+    }
+
+    /**
+     * @brief Write a scene in the binary format
+     * @param filename Output file
+     * @param scene Scene
+     * @param shardId Position of this file among the shards of a sharded export
+     * @param shardCount Number of shards of the export
+     */
+    void writeBinary(const std::string& filename, const Scene& scene, std::uint32_t shardId, std::uint32_t shardCount) {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error(filename + ": cannot open file for writing");
+        }
+
+        BinaryHeader header;
+        header.shardId = shardId;
+        header.shardCount = shardCount;
+        header.counts[0] = scene.points.size();
+        header.counts[1] = scene.segments.size();
+        header.counts[2] = scene.circles.size();
+        header.counts[3] = scene.triangles.size();
+        header.counts[4] = scene.rectangles.size();
+        header.bbox = boundingBox(scene);
+        writeBinaryHeader(out, header);
+
+        for (const Point_2_Visual& pv : scene.points) {
+            writePoint(out, pv);
+        }
+        for (const Segment_2_Visual& segv : scene.segments) {
+            writeColor(out, segv.getBondaryColor());
+            writeBoundaryType(out, segv.getBoundaryType());
+            writePoint(out, segv.source());
+            writePoint(out, segv.target());
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            writePod<double>(out, CGAL::to_double(circv.squared_radius()));
+            writeColor(out, circv.getBondaryColor());
+            writeBoundaryType(out, circv.getBoundaryType());
+            writeColor(out, circv.getInteriorColor());
+            writePoint(out, circv.center());
+        }
+        for (const Triangle_2_Visual& triv : scene.triangles) {
+            writeColor(out, triv.getBondaryColor());
+            writeBoundaryType(out, triv.getBoundaryType());
+            writeColor(out, triv.getInteriorColor());
+            writePoint(out, triv.vertex(0));
+            writePoint(out, triv.vertex(1));
+            writePoint(out, triv.vertex(2));
+        }
+        for (const Iso_rectangle_2_Visual& rectv : scene.rectangles) {
+            writeColor(out, rectv.getBondaryColor());
+            writeBoundaryType(out, rectv.getBoundaryType());
+            writeColor(out, rectv.getInteriorColor());
+            writePoint(out, rectv.min());
+            writePoint(out, rectv.max());
+        }
+
+        if (!out) {
+            throw std::runtime_error(filename + ": write failed");
+        }
+    }
+
+    /**
+     * @brief Read a scene written by writeBinary or mergeShards
+     * @param filename Input file
+     * @return Scene
+     */
+    Scene readBinary(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(filename + ": cannot open file");
+        }
+        BinaryHeader header = readBinaryHeader(in, filename);
+        const std::uint64_t* counts = header.counts;
+
+        Scene scene;
+        in.seekg(header.offsets[0]);
+        for (std::uint64_t i = 0; i < counts[0] && in; i++) {
+            scene.points.push_back(readBinaryPoint(in, filename));
+        }
+        in.seekg(header.offsets[1]);
+        for (std::uint64_t i = 0; i < counts[1] && in; i++) {
+            Color boundaryColor = readBinaryColor(in);
+            BoundaryType btype = toBoundaryType(readPod<std::int16_t>(in), filename);
+            Point_2_Visual s = readBinaryPoint(in, filename);
+            Point_2_Visual t = readBinaryPoint(in, filename);
+            scene.segments.push_back(Segment_2_Visual(s, t, boundaryColor, btype));
+        }
+        in.seekg(header.offsets[2]);
+        for (std::uint64_t i = 0; i < counts[2] && in; i++) {
+            double squaredRadius = readPod<double>(in);
+            Color boundaryColor = readBinaryColor(in);
+            BoundaryType btype = toBoundaryType(readPod<std::int16_t>(in), filename);
+            Color interiorColor = readBinaryColor(in);
+            Point_2_Visual center = readBinaryPoint(in, filename);
+            scene.circles.push_back(Circle_2_Visual(center, squaredRadius, boundaryColor, interiorColor, btype));
+        }
+        in.seekg(header.offsets[3]);
+        for (std::uint64_t i = 0; i < counts[3] && in; i++) {
+            Color boundaryColor = readBinaryColor(in);
+            BoundaryType btype = toBoundaryType(readPod<std::int16_t>(in), filename);
+            Color interiorColor = readBinaryColor(in);
+            Point_2_Visual p = readBinaryPoint(in, filename);
+            Point_2_Visual q = readBinaryPoint(in, filename);
+            Point_2_Visual r = readBinaryPoint(in, filename);
+            scene.triangles.push_back(Triangle_2_Visual(p, q, r, boundaryColor, interiorColor, btype));
+        }
+        in.seekg(header.offsets[4]);
+        for (std::uint64_t i = 0; i < counts[4] && in; i++) {
+            Color boundaryColor = readBinaryColor(in);
+            BoundaryType btype = toBoundaryType(readPod<std::int16_t>(in), filename);
+            Color interiorColor = readBinaryColor(in);
+            Point_2_Visual p = readBinaryPoint(in, filename);
+            Point_2_Visual q = readBinaryPoint(in, filename);
+            scene.rectangles.push_back(Iso_rectangle_2_Visual(p, q, boundaryColor, interiorColor, btype));
+        }
+
+        if (!in) {
+            throw std::runtime_error(filename + ": truncated file");
+        }
+        return scene;
+    }
+
+    /**
+     * @brief Read a scene, detecting text or binary format from the file content
+     * @param filename Input file
+     * @return Scene
+     */
+    Scene readScene(const std::string& filename) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(filename + ": cannot open file");
+        }
+        char magic[4] = {};
+        in.read(magic, sizeof(magic));
+        if (in && std::memcmp(magic, BinaryMagic, sizeof(magic)) == 0) {
+            return readBinary(filename);
+        }
+        return readText(filename);
+    }
+
+// Text output
+    /**
+     * @brief Write a scene in the text format of printToFile
+     * @param filename Output file
+     * @param scene Scene
+     */
+    void writeText(const std::string& filename, const Scene& scene) {
+        std::ofstream out(filename);
+        if (!out) {
+            throw std::runtime_error(filename + ": cannot open file for writing");
+        }
+
+        for (const Point_2_Visual& pv : scene.points) {
+            out << toString(pv) << '\n';
+        }
+        for (const Segment_2_Visual& segv : scene.segments) {
+            out << toString(segv) << '\n';
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            out << toString(circv) << '\n';
+        }
+        for (const Triangle_2_Visual& triv : scene.triangles) {
+            out << toString(triv) << '\n';
+        }
+        for (const Iso_rectangle_2_Visual& rectv : scene.rectangles) {
+            out << toString(rectv) << '\n';
+        }
+
+        if (!out) {
+            throw std::runtime_error(filename + ": write failed");
+        }
+    }
+
+// Scene operations
+    template <typename T>
+    static void append(std::vector<T>& into, const std::vector<T>& from) {
+        into.insert(into.end(), from.begin(), from.end());
+    }
+
+    /**
+     * @brief Append all shapes of a scene to another one
+     * @param into Scene receiving the shapes
+     * @param from Scene to append
+     */
+    void merge(Scene& into, const Scene& from) {
+        append(into.points, from.points);
+        append(into.segments, from.segments);
+        append(into.circles, from.circles);
+        append(into.triangles, from.triangles);
+        append(into.rectangles, from.rectangles);
+    }
+
+    template <typename T>
+    static void split(const std::vector<T>& shapes, std::vector<Scene>& shards, std::vector<T> Scene::* member) {
+        std::size_t count = shards.size();
+        for (std::size_t i = 0; i < count; i++) {
+            std::size_t first = shapes.size() * i / count;
+            std::size_t last = shapes.size() * (i + 1) / count;
+            (shards[i].*member).assign(shapes.begin() + first, shapes.begin() + last);
+        }
+    }
+
+    /**
+     * @brief Split a scene into shards of (almost) equal size
+     * @details Every shape type is split into contiguous ranges, so merging the shards in order restores the scene
+     * @param scene Scene
+     * @param count Number of shards (at least 1)
+     * @return Shards
+     */
+    std::vector<Scene> shard(const Scene& scene, std::size_t count) {
+        std::vector<Scene> shards(std::max<std::size_t>(count, 1));
+        split(scene.points, shards, &Scene::points);
+        split(scene.segments, shards, &Scene::segments);
+        split(scene.circles, shards, &Scene::circles);
+        split(scene.triangles, shards, &Scene::triangles);
+        split(scene.rectangles, shards, &Scene::rectangles);
+        return shards;
+    }
+
+    /**
+     * @brief Keep the points and circles that touch a viewport; they are never clipped
+     */
+    static void keepTouching(const Scene& scene, const Viewport& vp, Scene& result) {
+        for (const Point_2_Visual& pv : scene.points) {
+            double x = CGAL::to_double(pv.x());
+            double y = CGAL::to_double(pv.y());
+            if (x >= vp.xmin && x <= vp.xmax && y >= vp.ymin && y <= vp.ymax) {
+                result.points.push_back(pv);
+            }
+        }
+        for (const Circle_2_Visual& circv : scene.circles) {
+            double x = CGAL::to_double(circv.center().x());
+            double y = CGAL::to_double(circv.center().y());
+            double dx = std::max({vp.xmin - x, 0.0, x - vp.xmax});
+            double dy = std::max({vp.ymin - y, 0.0, y - vp.ymax});
+            if (dx * dx + dy * dy <= CGAL::to_double(circv.squared_radius())) {
+                result.circles.push_back(circv);
+            }
+        }
+    }
+
+    /**
+     * @brief Keep the shapes that clipping would keep, unchanged
+     */
+    template <typename ShapeVisual>
+    static std::vector<ShapeVisual> keepClipped(const std::vector<ShapeVisual>& shapes, const Viewport& vp) {
+        std::vector<std::size_t> sourceIndex;
+        clip(toBatch(shapes), vp, &sourceIndex);
+
+        // sourceIndex is ascending; a clipped triangle may appear several times
+        std::vector<ShapeVisual> result;
+        for (std::size_t k = 0; k < sourceIndex.size(); k++) {
+            if (k == 0 || sourceIndex[k] != sourceIndex[k - 1]) {
+                result.push_back(shapes[sourceIndex[k]]);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Restrict a scene to a viewport
+     * @details Segments, triangles and rectangles are clipped; points and circles are kept if they touch the viewport
+     * @param scene Scene
+     * @param vp Viewport
+     * @return Clipped scene
+     */
+    Scene clip(const Scene& scene, const Viewport& vp) {
+        Scene result;
+        keepTouching(scene, vp, result);
+        result.segments = clip(toBatch(scene.segments), vp);
+        result.triangles = clip(toBatch(scene.triangles), vp);
+        result.rectangles = clip(toBatch(scene.rectangles), vp);
+        return result;
+    }
+
+    /**
+     * @brief Drop the shapes outside a viewport
+     * @details Keeps the same shapes as clip, but unchanged. For rendering, where the view crops the shapes:
+     *          the triangle fan and the cut edges of clipped shapes would be stroked as shape edges.
+     * @param scene Scene
+     * @param vp Viewport
+     * @return Culled scene
+     */
+    Scene cull(const Scene& scene, const Viewport& vp) {
+        Scene result;
+        keepTouching(scene, vp, result);
+        result.segments = keepClipped(scene.segments, vp);
+        result.triangles = keepClipped(scene.triangles, vp);
+        result.rectangles = keepClipped(scene.rectangles, vp);
+        return result;
+    }
+
+} // namespace Geo2Util
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "geo2_util.h"
+#include "geo2_clip.h"
+
+namespace Geo2Util {
+
+    // A scene is the content of one dump file, grouped by shape type
+    struct Scene {
+        std::vector<Point_2_Visual> points;
+        std::vector<Segment_2_Visual> segments;
+        std::vector<Circle_2_Visual> circles;
+        std::vector<Triangle_2_Visual> triangles;
+        std::vector<Iso_rectangle_2_Visual> rectangles;
+
+        std::size_t size() const;
+    };
+
+    // Bounding box of all shapes; xmin > xmax if the scene is empty
+    Viewport boundingBox(const Scene& scene);
+
+    // Binary header
+    // Every binary file is a self-describing shard: shape counts, byte offset of each shape section and bounding box.
+    // A file produced by mergeShards also carries a global index locating every source shard in each section.
+    const int ShapeTypeCount = 5; // points, segments, circles, triangles, rectangles
+
+    struct ShardIndexEntry {
+        std::uint32_t shardId;
+        std::uint64_t counts[ShapeTypeCount];
+        std::uint64_t first[ShapeTypeCount]; // record index of the shard's first shape in each section
+        Viewport bbox;
+    };
+
+    struct BinaryHeader {
+        std::uint32_t version;
+        std::uint32_t shardId;
+        std::uint32_t shardCount;
+        std::uint64_t counts[ShapeTypeCount];
+        std::uint64_t offsets[ShapeTypeCount]; // byte offset of each section from the start of the file
+        Viewport bbox;
+        std::vector<ShardIndexEntry> index;
+    };
+
+    // Size in bytes of one record of a shape type, and of a header with the given number of index entries
+    std::uint64_t binaryRecordSize(int shapeType);
+    std::uint64_t binaryHeaderSize(std::size_t indexEntries);
+
+    // Header I/O; writeBinaryHeader fills in version and offsets from the counts and the index size
+    BinaryHeader readBinaryHeader(std::istream& in, const std::string& filename);
+    void writeBinaryHeader(std::ostream& out, BinaryHeader& header);
+
+    // Input: the format (text written by printToFile/writeText, or binary) is detected from the content
+    // Throws std::runtime_error if the file cannot be read or parsed
+    Scene readScene(const std::string& filename);
+    Scene readText(const std::string& filename);
+    Scene readBinary(const std::string& filename);
+
+    // Output; throws std::runtime_error if the file cannot be written
+    void writeText(const std::string& filename, const Scene& scene);
+    void writeBinary(const std::string& filename, const Scene& scene, std::uint32_t shardId = 0, std::uint32_t shardCount = 1);
+
+    // Scene operations
+    void merge(Scene& into, const Scene& from);
+    std::vector<Scene> shard(const Scene& scene, std::size_t count);
+    // clip cuts shapes at the viewport; cull keeps the same shapes whole, for rendering where the view crops them
+    Scene clip(const Scene& scene, const Viewport& vp);
+    Scene cull(const Scene& scene, const Viewport& vp);
+} // namespace Geo2Util
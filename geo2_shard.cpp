@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "geo2_shard.h"
+
+namespace Geo2Util {
+
+    // Copy buffer of the streaming merge
+    const std::size_t MergeBufferSize = 4 << 20;
+
+    static Viewport unite(const Viewport& a, const Viewport& b) {
+        return Viewport{std::min(a.xmin, b.xmin), std::min(a.ymin, b.ymin),
+                        std::max(a.xmax, b.xmax), std::max(a.ymax, b.ymax)};
+    }
+
+    /**
+     * @brief Name of a file next to output that does not exist yet
+     * @details A random suffix keeps concurrent merges to the same output apart; as the file does not exist,
+     *          it cannot be one of the inputs either
+     */
+    static std::string temporaryName(const std::string& output) {
+        std::random_device device;
+        std::mt19937_64 rng(static_cast<std::uint64_t>(device()) << 32
+                            ^ device()
+                            ^ static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        for (int attempt = 0; attempt < 16; attempt++) {
+            std::ostringstream name;
+            name << output << ".partial-" << std::hex << rng();
+            if (!std::filesystem::exists(name.str())) {
+                return name.str();
+            }
+        }
+        throw std::runtime_error(output + ": cannot find a free temporary file name");
+    }
+
+    /**
+     * @brief Check that a shard header describes the layout writeBinaryHeader produces
+     * @details The sections must follow the header and index back to back and end at the end of the file,
+     *          and the index entries of a merged file must split every section in order
+     */
+    static void checkLayout(const BinaryHeader& header, const std::string& filename) {
+        std::uint64_t end = binaryHeaderSize(header.index.size());
+        for (int t = 0; t < ShapeTypeCount; t++) {
+            if (header.offsets[t] != end) {
+                throw std::runtime_error(filename + ": section offsets do not match the header");
+            }
+            if (header.counts[t] > (std::numeric_limits<std::uint64_t>::max() - end) / binaryRecordSize(t)) {
+                throw std::runtime_error(filename + ": record counts out of range");
+            }
+            end += header.counts[t] * binaryRecordSize(t);
+        }
+        std::uint64_t fileSize = std::filesystem::file_size(filename);
+        if (fileSize != end) {
+            throw std::runtime_error(filename + ": file size " + std::to_string(fileSize)
+                                     + " does not match the header (" + std::to_string(end) + " bytes)");
+        }
+
+        if (header.index.empty()) {
+            return;
+        }
+        for (int t = 0; t < ShapeTypeCount; t++) {
+            std::uint64_t first = 0;
+            for (const ShardIndexEntry& entry : header.index) {
+                if (entry.first[t] != first || entry.counts[t] > header.counts[t] - first) {
+                    throw std::runtime_error(filename + ": index does not match the section counts");
+                }
+                first += entry.counts[t];
+            }
+            if (first != header.counts[t]) {
+                throw std::runtime_error(filename + ": index does not match the section counts");
+            }
+        }
+    }
+
+    /**
+     * @brief Copy bytes [offset, offset + size) of a file to a stream
+     */
+    static void copyRange(const std::string& filename, std::uint64_t offset, std::uint64_t size, std::ostream& out, std::vector<char>& buffer) {
+        if (size == 0) {
+            return;
+        }
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(filename + ": cannot open file");
+        }
+        in.seekg(offset);
+
+        while (size > 0) {
+            std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(size, buffer.size()));
+            in.read(buffer.data(), chunk);
+            if (static_cast<std::size_t>(in.gcount()) != chunk) {
+                throw std::runtime_error(filename + ": truncated file");
+            }
+            out.write(buffer.data(), chunk);
+            size -= chunk;
+        }
+    }
+
+    /**
+     * @brief Merge binary shards into one binary file with a global index
+     * @param shards Shard files written by writeBinary (or mergeShards)
+     * @param output Output file
+     * @param allowMissing Accept a subset of the shard ids 0..N-1
+     * @return Number of bytes written
+     */
+    std::uint64_t mergeShards(const std::vector<std::string>& shards, const std::string& output, bool allowMissing) {
+        if (shards.empty()) {
+            throw std::runtime_error("no shards to merge");
+        }
+        // Writing over an input would truncate it before its records are copied
+        if (std::filesystem::exists(output)) {
+            for (const std::string& filename : shards) {
+                if (std::filesystem::exists(filename) && std::filesystem::equivalent(filename, output)) {
+                    throw std::runtime_error(output + ": output is the same file as the input " + filename);
+                }
+            }
+        }
+
+        std::vector<BinaryHeader> headers;
+        headers.reserve(shards.size());
+        for (const std::string& filename : shards) {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in) {
+                throw std::runtime_error(filename + ": cannot open file");
+            }
+            headers.push_back(readBinaryHeader(in, filename));
+            checkLayout(headers.back(), filename);
+        }
+
+        // Shard ids held by each input: its own id, or the ids of its index if it was merged before
+        std::vector<std::vector<std::uint32_t>> ids(shards.size());
+        for (std::size_t i = 0; i < shards.size(); i++) {
+            if (headers[i].index.empty()) {
+                ids[i].push_back(headers[i].shardId);
+            } else {
+                for (const ShardIndexEntry& entry : headers[i].index) {
+                    ids[i].push_back(entry.shardId);
+                }
+            }
+        }
+
+        // The inputs must come from one export and hold every shard id 0..N-1 exactly once
+        std::uint32_t shardCount = headers[0].shardCount;
+        std::map<std::uint32_t, std::size_t> owner;
+        for (std::size_t i = 0; i < shards.size(); i++) {
+            if (headers[i].shardCount != shardCount) {
+                throw std::runtime_error(shards[i] + ": shard count " + std::to_string(headers[i].shardCount)
+                                         + " differs from " + std::to_string(shardCount) + " in " + shards[0]);
+            }
+            for (std::uint32_t id : ids[i]) {
+                if (id >= shardCount) {
+                    throw std::runtime_error(shards[i] + ": shard id " + std::to_string(id) + " out of range");
+                }
+                auto inserted = owner.emplace(id, i);
+                if (!inserted.second) {
+                    throw std::runtime_error("shard " + std::to_string(id) + " appears in both "
+                                             + shards[inserted.first->second] + " and " + shards[i]);
+                }
+            }
+        }
+        if (!allowMissing && owner.size() != shardCount) {
+            std::uint32_t missing = 0;
+            while (owner.count(missing)) {
+                missing++;
+            }
+            throw std::runtime_error(std::to_string(shardCount - owner.size()) + " of " + std::to_string(shardCount)
+                                     + " shards missing (first missing id: " + std::to_string(missing) + ")");
+        }
+
+        // Order by shard id; merged inputs must hold a range that does not interleave with the others
+        std::vector<std::size_t> order(shards.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return ids[a].front() < ids[b].front();
+        });
+        std::int64_t previous = -1;
+        for (std::size_t i : order) {
+            for (std::uint32_t id : ids[i]) {
+                if (id <= previous) {
+                    throw std::runtime_error(shards[i] + ": its shards interleave with those of another input");
+                }
+                previous = id;
+            }
+        }
+
+        const double inf = std::numeric_limits<double>::infinity();
+        BinaryHeader merged;
+        merged.shardId = ids[order.front()].front();
+        merged.shardCount = shardCount;
+        std::fill(std::begin(merged.counts), std::end(merged.counts), 0);
+        merged.bbox = Viewport{inf, inf, -inf, -inf};
+
+        for (std::size_t i : order) {
+            const BinaryHeader& header = headers[i];
+            if (header.index.empty()) {
+                ShardIndexEntry entry;
+                entry.shardId = header.shardId;
+                std::copy(std::begin(header.counts), std::end(header.counts), entry.counts);
+                std::copy(std::begin(merged.counts), std::end(merged.counts), entry.first);
+                entry.bbox = header.bbox;
+                merged.index.push_back(entry);
+            } else {
+                for (ShardIndexEntry entry : header.index) {
+                    for (int t = 0; t < ShapeTypeCount; t++) {
+                        entry.first[t] += merged.counts[t];
+                    }
+                    merged.index.push_back(entry);
+                }
+            }
+            for (int t = 0; t < ShapeTypeCount; t++) {
+                merged.counts[t] += header.counts[t];
+            }
+            merged.bbox = unite(merged.bbox, header.bbox);
+        }
+
+        // The records go to a temporary file that replaces the output only once the merge has succeeded
+        std::string partial = temporaryName(output);
+        try {
+            std::ofstream out(partial, std::ios::binary);
+            if (!out) {
+                throw std::runtime_error(partial + ": cannot open file for writing");
+            }
+            writeBinaryHeader(out, merged);
+
+            std::vector<char> buffer(MergeBufferSize);
+            for (int t = 0; t < ShapeTypeCount; t++) {
+                for (std::size_t i : order) {
+                    copyRange(shards[i], headers[i].offsets[t], headers[i].counts[t] * binaryRecordSize(t), out, buffer);
+                }
+            }
+
+            out.close();
+            if (!out) {
+                throw std::runtime_error(partial + ": write failed");
+            }
+            std::filesystem::rename(partial, output);
+        } catch (...) {
+            std::error_code ec;
+            std::filesystem::remove(partial, ec);
+            throw;
+        }
+        return merged.offsets[ShapeTypeCount - 1] + merged.counts[ShapeTypeCount - 1] * binaryRecordSize(ShapeTypeCount - 1);
+    }
+
+} // namespace Geo2Util
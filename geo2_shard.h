@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "geo2_scene.h"
+
+namespace Geo2Util {
+
+    // Sharded export
+    // Each process writes its part of the geometry with writeBinary(filename, scene, shardId, shardCount).
+    // mergeShards combines the shards into one binary file, ordered by shard id, with a global index recording
+    // where every shard's shapes landed. Records are copied section by section with streaming I/O, so memory use
+    // does not depend on the shard size.
+    // The inputs must share one shard count N and hold every id 0..N-1 exactly once (allowMissing relaxes the
+    // latter). A merged file holds the ids of its index and can be merged again with the remaining shards.
+    // The output is written to a new file OUTPUT.partial-<random> and renamed to OUTPUT on success, so a failed
+    // merge leaves no partial file and an existing OUTPUT untouched. An output that is one of the inputs is rejected.
+
+    // Return the number of bytes written; throws std::runtime_error on I/O errors, malformed shards or an invalid shard set
+    std::uint64_t mergeShards(const std::vector<std::string>& shards, const std::string& output, bool allowMissing = false);
+} // namespace Geo2Util
@@ -1,73 +1,443 @@
-
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
 #include <iostream>
-#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "geo2_util.h"
+#include "geo2_clip.h"
+#include "geo2_scene.h"
+#include "geo2_render.h"
+#include "geo2_shard.h"
 
 using namespace std;
-typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
-typedef K::Point_2 Point_2;
-typedef K::Circle_2 Circle_2;
-typedef K::Iso_rectangle_2 Iso_rectangle_2;
-typedef K::Triangle_2 Triangle_2;
-typedef K::Segment_2 Segment_2;
+using namespace Geo2Util;
+namespace fs = std::filesystem;
+
+// Batch converter for scene dumps
+// Inputs are text (printToFile) or binary files; outputs are text, binary, SVG or PPM.
+// Several inputs are either merged into one output (--merge) or converted one by one into an output directory.
+// Binary shards written by several processes (--shard-id/--shard-count) are combined with --merge-shards.
+
+enum class Format {
+    Text,
+    Binary,
+    Svg,
+    Ppm
+};
+
+// Limits of the count options; shard ids are stored as uint32 in binary headers
+const unsigned long long MaxShardCount = UINT32_MAX;
+const unsigned long long MaxImageSize = 65536;
+const unsigned long long MaxThreads = 1024;
+
+struct Options {
+    vector<string> inputs;
+    string output;
+    Format format = Format::Text;
+    bool formatGiven = false;
+    bool merge = false;
+    size_t shards = 1;
+    uint32_t shardId = 0;
+    uint32_t shardCount = 1;
+    bool mergeShards = false;
+    bool allowMissingShards = false;
+    bool hasViewport = false;
+    Viewport viewport{0, 0, 0, 0};
+    int width = 1024;
+    int height = 1024;
+    unsigned threads = 0;
+    bool quiet = false;
+};
+
+static void usage(ostream& out)
+{
+    out << "usage: geo2d_visual [options] -o OUTPUT INPUT...\n"
+        << "  -o, --output PATH       output file; output directory when several inputs are converted one by one\n"
+        << "  -f, --format FORMAT     text, binary, svg or ppm (default: from the output extension, text if there is none)\n"
+        << "      --merge             merge all inputs, in the given order, into one output\n"
+        << "      --shards N          split every output into N files named PATH.0.EXT ... PATH.<N-1>.EXT\n"
+        << "      --shard-id I        binary output is shard I of a sharded export (default 0)\n"
+        << "      --shard-count N     number of shards of the export (default 1)\n"
+        << "      --merge-shards      stream binary shards, ordered by shard id, into one binary OUTPUT with a global index\n"
+        << "      --allow-missing-shards\n"
+        << "                          with --merge-shards, accept a subset of the shards of the export\n"
+        << "      --viewport XMIN YMIN XMAX YMAX\n"
+        << "                          keep only the geometry inside the viewport; for text and binary, segments, triangles and\n"
+        << "                          rectangles are clipped; for svg and ppm, shapes are kept whole and the image is cropped\n"
+        << "      --size WxH          raster size for ppm output (default 1024x1024)\n"
+        << "      --threads N         worker threads (default: number of cores)\n"
+        << "  -q, --quiet             no progress output\n"
+        << "  -h, --help              show this help\n";
+}
 
+static bool parseFormat(const string& s, Format& format)
+{
+    if (s == "text" || s == "txt") {
+        format = Format::Text;
+    } else if (s == "binary" || s == "bin") {
+        format = Format::Binary;
+    } else if (s == "svg") {
+        format = Format::Svg;
+    } else if (s == "ppm") {
+        format = Format::Ppm;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static string extension(Format format)
+{
+    switch (format) {
+        case Format::Binary : return ".bin";
+        case Format::Svg : return ".svg";
+        case Format::Ppm : return ".ppm";
+        default: return ".txt";
+    }
+}
+
+// Unsigned integer option value in [0, maxValue]; rejects signs, fractions and trailing characters
+static unsigned long long toCount(const string& s, unsigned long long maxValue)
+{
+    if (s.empty() || !all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw invalid_argument(s + " is not a non-negative integer");
+    }
+    unsigned long long value = 0;
+    try {
+        value = stoull(s);
+    } catch (const out_of_range&) {
+        value = ULLONG_MAX;
+    }
+    if (value > maxValue) {
+        throw invalid_argument(s + " is larger than " + to_string(maxValue));
+    }
+    return value;
+}
+
+static double toNumber(const string& s)
+{
+    size_t pos = 0;
+    double value = stod(s, &pos);
+    if (pos != s.size()) {
+        throw invalid_argument(s);
+    }
+    return value;
+}
 
-int main()
+// Return false (after printing a message) if the command line is invalid
+static bool parseOptions(int argc, char* argv[], Options& opt)
 {
-    // Point_2 p0(12, -15), p1(-10, -25.3), p2(-0.01, 0.2);
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            auto next = [&]() -> string {
+                if (i + 1 >= argc) {
+                    throw invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help") {
+                usage(cout);
+                exit(0);
+            } else if (arg == "-o" || arg == "--output") {
+                opt.output = next();
+            } else if (arg == "-f" || arg == "--format") {
+                string s = next();
+                if (!parseFormat(s, opt.format)) {
+                    throw invalid_argument("unknown format " + s);
+                }
+                opt.formatGiven = true;
+            } else if (arg == "--merge") {
+                opt.merge = true;
+            } else if (arg == "--shards") {
+                opt.shards = static_cast<size_t>(toCount(next(), MaxShardCount));
+            } else if (arg == "--shard-id") {
+                opt.shardId = static_cast<uint32_t>(toCount(next(), MaxShardCount));
+            } else if (arg == "--shard-count") {
+                opt.shardCount = static_cast<uint32_t>(toCount(next(), MaxShardCount));
+            } else if (arg == "--merge-shards") {
+                opt.mergeShards = true;
+            } else if (arg == "--allow-missing-shards") {
+                opt.allowMissingShards = true;
+            } else if (arg == "--viewport") {
+                opt.viewport.xmin = toNumber(next());
+                opt.viewport.ymin = toNumber(next());
+                opt.viewport.xmax = toNumber(next());
+                opt.viewport.ymax = toNumber(next());
+                opt.hasViewport = true;
+            } else if (arg == "--size") {
+                string s = next();
+                size_t x = s.find('x');
+                if (x == string::npos) {
+                    throw invalid_argument("size must be WxH");
+                }
+                opt.width = static_cast<int>(toCount(s.substr(0, x), MaxImageSize));
+                opt.height = static_cast<int>(toCount(s.substr(x + 1), MaxImageSize));
+            } else if (arg == "--threads") {
+                opt.threads = static_cast<unsigned>(toCount(next(), MaxThreads));
+            } else if (arg == "-q" || arg == "--quiet") {
+                opt.quiet = true;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw invalid_argument("unknown option " + arg);
+            } else {
+                opt.inputs.push_back(arg);
+            }
+        }
+    } catch (const exception& e) {
+        cerr << "geo2d_visual: invalid argument: " << e.what() << "\n";
+        usage(cerr);
+        return false;
+    }
+
+    if (opt.inputs.empty() || opt.output.empty()) {
+        usage(cerr);
+        return false;
+    }
+    if (opt.shards < 1 || opt.shardCount < 1 || opt.width <= 0 || opt.height <= 0) {
+        cerr << "geo2d_visual: --shards, --shard-count and --size must be positive\n";
+        return false;
+    }
+    if (opt.shardId >= opt.shardCount) {
+        cerr << "geo2d_visual: --shard-id must be less than --shard-count\n";
+        return false;
+    }
+    if (static_cast<unsigned long long>(opt.shardCount) * opt.shards > MaxShardCount) {
+        cerr << "geo2d_visual: --shard-count times --shards must not exceed " << MaxShardCount << "\n";
+        return false;
+    }
+    if (opt.mergeShards && (opt.merge || opt.hasViewport || opt.shards != 1)) {
+        cerr << "geo2d_visual: --merge-shards cannot be combined with --merge, --viewport or --shards\n";
+        return false;
+    }
+    if (opt.hasViewport && (opt.viewport.xmin > opt.viewport.xmax || opt.viewport.ymin > opt.viewport.ymax)) {
+        cerr << "geo2d_visual: empty viewport\n";
+        return false;
+    }
+    if (!opt.formatGiven) {
+        // A file output with an unknown extension would silently get a text dump; a directory output only names files
+        bool directoryOutput = !opt.merge && !opt.mergeShards && opt.inputs.size() > 1;
+        string ext = fs::path(opt.output).extension().string();
+        if (!ext.empty() && !parseFormat(ext.substr(1), opt.format) && !directoryOutput && !opt.mergeShards) {
+            cerr << "geo2d_visual: unknown output extension " << ext << ", use -f to choose the format\n";
+            return false;
+        }
+    }
+    if ((opt.shardId != 0 || opt.shardCount != 1) && (opt.mergeShards || opt.format != Format::Binary)) {
+        cerr << "geo2d_visual: --shard-id and --shard-count only apply when writing binary shards\n";
+        return false;
+    }
+    if (opt.threads == 0) {
+        opt.threads = max(1u, thread::hardware_concurrency());
+    }
+    return true;
+}
+
+// Progress and throughput on stderr, shared by the worker threads
+class Progress {
+private:
+    mutex m_mutex;
+    size_t m_total;
+    size_t m_done = 0;
+    size_t m_shapes = 0;
+    bool m_quiet;
+    chrono::steady_clock::time_point m_start = chrono::steady_clock::now();
+public:
+    Progress(size_t total, bool quiet) : m_total(total), m_quiet(quiet) {}
 
-    // Point_2 s1(10, 10), s2(40, 40);
-    // Segment_2 seg(s1, s2);
+    void fileDone(size_t shapes) {
+        lock_guard<mutex> lock(m_mutex);
+        m_done++;
+        m_shapes += shapes;
+        if (!m_quiet) {
+            cerr << "\r[" << m_done << "/" << m_total << " files] " << m_shapes << " shapes, "
+                 << static_cast<long long>(m_shapes / seconds()) << " shapes/s" << flush;
+        }
+    }
 
-    // Point_2 p(10, 10), q(20, 15), s(10, 15);
-    // Triangle_2 tri(p, q, s);
+    void finish() {
+        lock_guard<mutex> lock(m_mutex);
+        if (!m_quiet) {
+            cerr << "\n" << m_done << " files, " << m_shapes << " shapes in " << seconds() << " s ("
+                 << static_cast<long long>(m_done / seconds() * 3600) << " files/h)\n";
+        }
+    }
 
-    // Circle_2 circ(p, 4);
+    double seconds() const {
+        return max(1e-9, chrono::duration<double>(chrono::steady_clock::now() - m_start).count());
+    }
+};
 
-    // Iso_rectangle_2 rect(p, q);
+// Run task(0) ... task(count - 1) on up to `threads` threads; returns false if any task threw
+static bool runParallel(size_t count, unsigned threads, const function<void(size_t)>& task)
+{
+    atomic<size_t> next{0};
+    atomic<bool> ok{true};
+    mutex errorMutex;
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (const exception& e) {
+                lock_guard<mutex> lock(errorMutex);
+                cerr << "\ngeo2d_visual: " << e.what() << "\n";
+                ok = false;
+            }
+        }
+    };
 
+    vector<thread> pool;
+    size_t n = min<size_t>(threads, count);
+    for (size_t t = 1; t < n; t++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (thread& t : pool) {
+        t.join();
+    }
+    return ok;
+}
+
+// Rendered formats keep shapes whole: the view crops them, and clipped shapes would be stroked along the cuts
+static Scene restrictToViewport(const Scene& scene, const Options& opt)
+{
+    if (opt.format == Format::Svg || opt.format == Format::Ppm) {
+        return cull(scene, opt.viewport);
+    }
+    return clip(scene, opt.viewport);
+}
 
-    // std::vector<std::string> geomObjectArray;
-    // geomObjectArray.reserve(7); // only for observation purpose in this case; can be deleted
+// shardIndex/shardTotal: position of the file among the --shards outputs of this process
+static void writeScene(const string& filename, const Scene& scene, const Options& opt, size_t shardIndex = 0, size_t shardTotal = 1)
+{
+    Viewport view = opt.hasViewport ? opt.viewport : boundingBox(scene);
+    if (view.xmin > view.xmax) {
+        view = Viewport{0, 0, 1, 1};
+    }
 
-    // geomObjectArray.push_back(Geo2Util::toString(p0));
-    // geomObjectArray.push_back(Geo2Util::toString(p1));
-    // geomObjectArray.push_back(Geo2Util::toString(p2));
-    // geomObjectArray.push_back(Geo2Util::toString(seg));
+    switch (opt.format) {
+        case Format::Binary : writeBinary(filename, scene,
+                                          static_cast<uint32_t>(opt.shardId * shardTotal + shardIndex),
+                                          static_cast<uint32_t>(opt.shardCount * shardTotal)); break;
+        case Format::Svg : writeSvg(filename, scene, view); break;
+        case Format::Ppm : writePpm(filename, scene, view, opt.width, opt.height); break;
+        default: writeText(filename, scene); break;
+    }
+}
 
-    // //geomObjectArray[0] = Geo2Util::toString(p0);
-    // //geomObjectArray[1] = Geo2Util::toString(p1);
-    // //geomObjectArray[2] = Geo2Util::toString(p2);
-    // //geomObjectArray[3] = Geo2Util::toString(seg); 
-    // //geomObjectArray[4] = Geo2Util::toString(s1);
-    // //geomObjectArray[5] = Geo2Util::toString(s2);
+// Files written for output path: path itself, or path.0.ext ... when sharding
+static vector<fs::path> outputFiles(const fs::path& path, const Options& opt)
+{
+    if (opt.shards == 1) {
+        return {path};
+    }
+    vector<fs::path> files;
+    for (size_t i = 0; i < opt.shards; i++) {
+        files.push_back(path.parent_path() / (path.stem().string() + "." + to_string(i) + path.extension().string()));
+    }
+    return files;
+}
 
-    // geomObjectArray.push_back(Geo2Util::toString(circ));
+static void writeOutput(const fs::path& path, const Scene& scene, const Options& opt)
+{
+    vector<fs::path> files = outputFiles(path, opt);
+    if (files.size() == 1) {
+        writeScene(files[0].string(), scene, opt);
+        return;
+    }
+    vector<Scene> shards = shard(scene, opt.shards);
+    for (size_t i = 0; i < shards.size(); i++) {
+        writeScene(files[i].string(), shards[i], opt, i, shards.size());
+    }
+}
 
-    // //geomObjectArray[6] = Geo2Util::toString(circ);
-    // //geomObjectArray[7] = Geo2Util::toString(p);
+// Output path of every input in directory mode; throws if two inputs would write the same file
+static vector<fs::path> directoryOutputs(const Options& opt)
+{
+    vector<fs::path> outputs;
+    map<string, size_t> writers;
+    for (size_t i = 0; i < opt.inputs.size(); i++) {
+        outputs.push_back(fs::path(opt.output) / (fs::path(opt.inputs[i]).stem().string() + extension(opt.format)));
+        for (const fs::path& file : outputFiles(outputs.back(), opt)) {
+            auto inserted = writers.emplace(fs::absolute(file).lexically_normal().string(), i);
+            if (!inserted.second) {
+                throw runtime_error(opt.inputs[inserted.first->second] + " and " + opt.inputs[i]
+                                    + " would both be written to " + file.string());
+            }
+        }
+    }
+    return outputs;
+}
 
-    // geomObjectArray.push_back(Geo2Util::toString(tri));
+int main(int argc, char* argv[])
+{
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        return 2;
+    }
 
-    // //geomObjectArray[8] = Geo2Util::toString(tri);
-    // //geomObjectArray[9] = Geo2Util::toString(p);
-    // //geomObjectArray[10] = Geo2Util::toString(q);
-    // //geomObjectArray[11] = Geo2Util::toString(s);
+    Progress progress(opt.inputs.size(), opt.quiet);
+    bool ok = true;
 
-    // geomObjectArray.push_back(Geo2Util::toString(rect));
+    try {
+        if (opt.mergeShards) {
+            // Streaming copy; throughput is reported in bytes since shapes are never decoded
+            auto start = chrono::steady_clock::now();
+            uint64_t bytes = Geo2Util::mergeShards(opt.inputs, opt.output, opt.allowMissingShards);
+            double seconds = max(1e-9, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+            if (!opt.quiet) {
+                cerr << opt.inputs.size() << " shards, " << bytes << " bytes merged in " << seconds << " s ("
+                     << bytes / seconds / (1 << 20) << " MiB/s)\n";
+            }
+            return 0;
+        } else if (opt.merge || opt.inputs.size() == 1) {
+            // Inputs are read in parallel and merged in command line order
+            vector<Scene> scenes(opt.inputs.size());
+            ok = runParallel(opt.inputs.size(), opt.threads, [&](size_t i) {
+                scenes[i] = readScene(opt.inputs[i]);
+                if (opt.hasViewport) {
+                    scenes[i] = restrictToViewport(scenes[i], opt);
+                }
+                progress.fileDone(scenes[i].size());
+            });
+            if (ok) {
+                Scene merged;
+                for (Scene& scene : scenes) {
+                    merge(merged, scene);
+                    scene = Scene();
+                }
+                writeOutput(opt.output, merged, opt);
+            }
+        } else {
+            vector<fs::path> outputs = directoryOutputs(opt);
+            fs::create_directories(opt.output);
+            ok = runParallel(opt.inputs.size(), opt.threads, [&](size_t i) {
+                Scene scene = readScene(opt.inputs[i]);
+                if (opt.hasViewport) {
+                    scene = restrictToViewport(scene, opt);
+                }
+                writeOutput(outputs[i], scene, opt);
+                progress.fileDone(scene.size());
+            });
+        }
+    } catch (const exception& e) {
+        cerr << "\ngeo2d_visual: " << e.what() << "\n";
+        ok = false;
+    }
 
-    // //geomObjectArray[12] = Geo2Util::toString(rect);
-    // //geomObjectArray[13] = Geo2Util::toString(p);
-    // //geomObjectArray[14] = Geo2Util::toString(q);
-  
-   
-    // Geo2Util::printToFile("test.txt", geomObjectArray);
-    cout << Geo2Util::OpaqueBlack.r << "\n"
-            << Geo2Util::OpaqueBlack.g << "\n"
-            << Geo2Util::OpaqueBlack.b << "\n"
-            << Geo2Util::OpaqueBlack.trans << "\n";
+    progress.finish();
+    return ok ? 0 : 1;
 }